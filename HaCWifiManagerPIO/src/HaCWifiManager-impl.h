@@ -24,7 +24,7 @@
 
 
 /* #region SELF_HEADER */
-#include "HaCwifimanager.h"
+#include "HaCWifiManager.h"
 /* #endregion */
 
 /* #region CLASS_DEFINITION */
@@ -38,6 +38,12 @@ HaCWifiManager::HaCWifiManager() {
      this->_wifiParam->onDebug([&](const char *msg){
           DEBUG_CALLBACK_HAC(msg);     
      });
+     //Rssi and access point clients change without an event, the snapshot is refreshed periodically
+     this->_statusTimer = Tick(STATUS_REFRESH_INTERVAL, this->_timers);
+     this->_statusTimer.onTick([&]()
+     {
+          this->_statusDirty = true;
+     });
  
 }
 
@@ -45,7 +51,10 @@ HaCWifiManager::HaCWifiManager() {
      * Constructor.
      */
 HaCWifiManager::~HaCWifiManager() {
+     this->endTask();
      if(this->_wifiParam) delete this->_wifiParam;
+     if(this->_eventRing) delete this->_eventRing;
+     if(this->_connectRing) delete this->_connectRing;
 }
 
 /**
@@ -84,6 +93,163 @@ void HaCWifiManager::setup(const char *wifiJsonStr)
      }
 }
 
+/**
+     * Reload the wifi parameters without a full setup.
+     * Note: Only the parts which changed are restarted. The station link is kept if the
+     * connected network is still on the wifi list with the same credential and network
+     * profile, and the access point is kept if only station parameters changed.
+     * @param wifiJsonStr Wifi Parameters in Json String format
+     * @return What was restarted and the downtime incurred, the station downtime is
+     * only known once the station is ready, see getLastReloadResult
+     */
+t_reloadResult HaCWifiManager::reload(const char *wifiJsonStr)
+{
+     this->_lastReload = t_reloadResult();
+     if(!this->_wifiParam) this->_initParam();
+     if(!this->_wifiParam) return this->_lastReload;
+
+     //Validate the new parameters before touching the running configuration, the
+     //document holds most of the heap and is released before the parameters are parsed
+     {
+          DynamicJsonDocument doc(__ESP_HEAPS_BLOCK_SIZE__ - 8192);
+          if (deserializeJson(doc, wifiJsonStr))
+          {
+               DEBUG_CALLBACK_HAC(F("Failed to resolve wifi parameters, due to invalid json format!"));
+               return this->_lastReload;
+          }
+     }
+
+     HACWifiManagerParameters *newParam = new HACWifiManagerParameters();
+     newParam->onDebug([&](const char *msg){
+          DEBUG_CALLBACK_HAC(msg);     
+     });
+     newParam->setHostName(DEFAULT_HOST_NAME);
+     newParam->fromJson(wifiJsonStr);
+
+     if (newParam->getMode() < STA_ONLY || newParam->getMode() > BOTH_STA_AP)
+     {
+          this->_printError(1);
+          DEBUG_CALLBACK_HAC(F("Invalid wifi mode!"));
+          delete newParam;
+          return this->_lastReload;
+     }
+     if (newParam->getMode() != AP_ONLY && newParam->getWifiListCount() == 0)
+     {
+          this->_printError(2);
+          DEBUG_CALLBACK_HAC(F("There is no ssid configured!"));
+          delete newParam;
+          return this->_lastReload;
+     }
+
+     //Same default as the access point setup so an unchanged access point is not restarted
+     if (newParam->accessPointInfo.ssid == "null")
+     {
+          newParam->accessPointInfo.ssid = String(___DEF_SSID___);
+          newParam->accessPointInfo.pass = String(___DEF_PASS___);
+     }
+
+     //Diff the running and the new parameters
+     uint8_t oldMode = this->_wifiParam->getMode();
+     uint8_t newMode = newParam->getMode();
+     bool oldSta = oldMode != AP_ONLY, newSta = newMode != AP_ONLY;
+     bool oldAp = oldMode != STA_ONLY, newAp = newMode != STA_ONLY;
+     bool staChanged = !this->_wifiParam->staEquals(newParam);
+     bool apChanged = !this->_wifiParam->apEquals(newParam);
+     bool hostNameChanged = strcmp(this->_wifiParam->getHostName(), newParam->getHostName()) != 0;
+
+     //Keep the station link if the connected network is still valid
+     int16_t keepIndex = -1;
+     if (oldSta && newSta && this->_staState.state() == STA_CONNECTED)
+     {
+          String ssid = WiFi.SSID();
+          int16_t oldIndex = this->_wifiParam->getWifiIndex(ssid.c_str());
+          int16_t newIndex = newParam->getWifiIndex(ssid.c_str());
+          if (oldIndex >= 0 && newIndex >= 0 &&
+              this->_wifiParam->wifiInfo[oldIndex].pass == newParam->wifiInfo[newIndex].pass &&
+              this->_wifiParam->getWifiEnableDHCP(oldIndex) == newParam->getWifiEnableDHCP(newIndex) &&
+              HACWifiManagerParameters::networkInfoEquals(this->_wifiParam->getWifiNetworkInfo(oldIndex),
+                                                          newParam->getWifiNetworkInfo(newIndex)))
+               keepIndex = newIndex;
+     }
+
+     //Corrected credentials are given a new chance
+     for (auto &entry : newParam->wifiInfo)
+     {
+          int16_t oldIndex = this->_wifiParam->getWifiIndex(entry.ssid.c_str());
+          if (oldIndex >= 0 && this->_wifiParam->wifiInfo[oldIndex].pass != entry.pass)
+               this->releaseQuarantine(entry.ssid.c_str());
+     }
+
+     //Swap the parameters
+     delete this->_wifiParam;
+     this->_wifiParam = newParam;
+     if (keepIndex >= 0) this->_staCandidateIndex = keepIndex;
+     this->_save();
+
+     //The station goes down before the mode switch, shutdownSTA() would turn the radio off
+     if (oldSta && !newSta)
+     {
+          if (this->_connectOp.id && this->_connectOp.result == CONNECT_PENDING)
+               this->_completeConnectRequest(CONNECT_CANCELLED);
+          this->_stopStation();
+          WiFi.disconnect(false);
+     }
+
+     if (oldMode != newMode)
+     {
+          WiFi.mode(newMode == STA_ONLY ? WIFI_STA : (newMode == AP_ONLY ? WIFI_AP : WIFI_AP_STA));
+          this->_statusDirty = true;
+     }
+
+     //Access point
+     if (oldAp && !newAp)
+          this->shutdownAP();
+     else if (newAp && (!oldAp || apChanged))
+     {
+          unsigned long apDownAt = millis();
+          this->_apStartupTimer.stop();
+          if (oldAp) WiFi.softAPdisconnect(false);
+          this->_apFlagStarted = false;
+          this->_startAccessPoint();
+          this->_lastReload.apRestarted = true;
+          this->_lastReload.apDowntimeMs = millis() - apDownAt;
+          //The ready edge is not seen by the loop, the snapshot is refreshed here
+          this->_statusDirty = true;
+     }
+
+     //Station
+     if (newSta && keepIndex < 0 && (staChanged || !oldSta))
+     {
+          this->_reloadStaDownAt = millis();
+          this->_reloadStaPending = true;
+          this->_lastReload.staRestarted = true;
+
+          this->_stopStation();
+          WiFi.disconnect();
+          this->_initStation();
+     }
+     else if (keepIndex >= 0 && hostNameChanged && this->_initMdnsFlagOnce)
+     {
+          //Only the host name changed on the kept link
+          MDNS.end();
+          this->_startMdns();
+     }
+
+     this->_lastReload.applied = true;
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG136, this->_lastReload.staRestarted,
+                         this->_lastReload.apRestarted, this->_lastReload.apDowntimeMs);
+     return this->_lastReload;
+}
+
+/**
+     * Getting the result of the last configuration reload.
+     * @return Last reload result
+     */
+const t_reloadResult &HaCWifiManager::getLastReloadResult()
+{
+     return this->_lastReload;
+}
+
 /**
      * Called when setting up the library.
      * Note: Wifi parameters passed as json data.
@@ -183,14 +349,22 @@ void HaCWifiManager::setup()
      }
 
 
-     //Initialize watchdog timer
-     this->_staWatchdogTimer = Tick(30000);
-     this->_staStartupTimer = Tick(1000);
-     this->_wifiScanTimer = Tick((unsigned long)WIFI_SCAN_TIMEOUT);
+     //Register the wifi events once
+     this->_registerWifiEvents();
+
+     //Seed the reconnect jitter per device
+     this->_seedReconnectBackoff();
+
+     //Initialize timers
+     //Note: Station waits are handled by the connection flows
+     this->_apStartupTimer = Tick((unsigned long)STARTUP_SETTLE_DELAY, this->_timers);
 
      //Wifi is ready for start up
      DEBUG_CALLBACK_HAC(F("Initializing  manager.."));
      this->_initWifiManager();
+
+     //Readers get a snapshot before the first loop
+     this->_publishStatus();
 }
 
 
@@ -223,7 +397,9 @@ WifiMode HaCWifiManager::getMode()
      */
 void HaCWifiManager::getStaIP(char *ip)
 {     
-     strcpy(ip, &(WiFi.localIP().toString())[0]);
+     t_wifiStatus status;
+     this->_readStatus(status);
+     HaCWifiManager::_ipToStr(status.staIp, ip);
 }
 
 /**
@@ -232,7 +408,9 @@ void HaCWifiManager::getStaIP(char *ip)
      */
 void HaCWifiManager::getStaSubnetMask(char *sn)
 {     
-     strcpy(sn, &(WiFi.subnetMask().toString())[0]);
+     t_wifiStatus status;
+     this->_readStatus(status);
+     HaCWifiManager::_ipToStr(status.staSubnet, sn);
 }
 
 /**
@@ -241,7 +419,9 @@ void HaCWifiManager::getStaSubnetMask(char *sn)
      */
 void HaCWifiManager::getGateway(char *gw)
 {     
-     strcpy(gw, &(WiFi.gatewayIP().toString())[0]);
+     t_wifiStatus status;
+     this->_readStatus(status);
+     HaCWifiManager::_ipToStr(status.staGateway, gw);
 }
 
 /**
@@ -250,10 +430,9 @@ void HaCWifiManager::getGateway(char *gw)
      */
 void HaCWifiManager::getAPIP(char *ip)
 {  
-     __TCP_INFO__ info;      
-     __TCP_ADAPTER_GET_IP_INFO(__TCP_ADAPTER_INTERFACE__, &info);     
-
-     strcpy(ip, &(IPAddress(info.ip.addr).toString())[0]);
+     t_wifiStatus status;
+     this->_readStatus(status);
+     HaCWifiManager::_ipToStr(status.apIp, ip);
 }
 
 /**
@@ -262,10 +441,9 @@ void HaCWifiManager::getAPIP(char *ip)
      */
 void HaCWifiManager::getAPSubnet(char *sn)
 {  
-     __TCP_INFO__ info;  
-     __TCP_ADAPTER_GET_IP_INFO(__TCP_ADAPTER_INTERFACE__, &info);   
-
-     strcpy(sn, &(IPAddress(info.netmask.addr).toString())[0]);
+     t_wifiStatus status;
+     this->_readStatus(status);
+     HaCWifiManager::_ipToStr(status.apSubnet, sn);
 }
 
 /**
@@ -274,10 +452,9 @@ void HaCWifiManager::getAPSubnet(char *sn)
      */
 void HaCWifiManager::getAPGateway(char *gw)
 {  
-     __TCP_INFO__ info;  
-     __TCP_ADAPTER_GET_IP_INFO(__TCP_ADAPTER_INTERFACE__, &info);   
-
-     strcpy(gw, &(IPAddress(info.gw.addr).toString())[0]);
+     t_wifiStatus status;
+     this->_readStatus(status);
+     HaCWifiManager::_ipToStr(status.apGateway, gw);
 }
 
 /**
@@ -286,16 +463,9 @@ void HaCWifiManager::getAPGateway(char *gw)
      */
 void HaCWifiManager::getDNS1(char *dns1)
 {  
-     __TCP_INFO__ info;
-
-     #ifdef ESP8266
-     info.ip.addr = dns_getserver(1)->addr;
-     #endif
-     #ifdef ESP32
-     info.ip.addr = dns_getserver(1)->u_addr.ip4.addr;
-     #endif
-     
-     strcpy(dns1, &(IPAddress(info.ip.addr).toString())[0]);
+     t_wifiStatus status;
+     this->_readStatus(status);
+     HaCWifiManager::_ipToStr(status.dns1, dns1);
 }
 
 /**
@@ -304,16 +474,9 @@ void HaCWifiManager::getDNS1(char *dns1)
      */
 void HaCWifiManager::getDNS2(char *dns2)
 {  
-     __TCP_INFO__ info;
-     
-     #ifdef ESP8266
-     info.ip.addr = dns_getserver(2)->addr;
-     #endif
-     #ifdef ESP32
-     info.ip.addr = dns_getserver(2)->u_addr.ip4.addr;
-     #endif
-     
-     strcpy(dns2, &(IPAddress(info.ip.addr).toString())[0]);
+     t_wifiStatus status;
+     this->_readStatus(status);
+     HaCWifiManager::_ipToStr(status.dns2, dns2);
 }
 
 /**
@@ -322,7 +485,9 @@ void HaCWifiManager::getDNS2(char *dns2)
      */
 void HaCWifiManager::getSTAWifiSSID(char *ssid)
 {  
-     strcpy(ssid, &(WiFi.SSID())[0]);
+     t_wifiStatus status;
+     this->_readStatus(status);
+     strcpy(ssid, status.ssid);
 }
 
 /**
@@ -331,7 +496,427 @@ void HaCWifiManager::getSTAWifiSSID(char *ssid)
      */
 void HaCWifiManager::getAPWifiSSID(char *ssid)
 {  
-     strcpy(ssid, &(WiFi.softAPSSID())[0]);
+     t_wifiStatus status;
+     this->_readStatus(status);
+     strcpy(ssid, status.apSsid);
+}
+
+/**
+     * Request a connection to a network of the wifi list.
+     * Note: The request runs on the manager loop, the handle tells when it is done. A
+     * password adds the network to the wifi list or updates its password. A later request
+     * cancels a running one. If the network fails the manager moves on with the wifi list.
+     * @param ssid Network ssid
+     * @param pass Network password, nullptr to use the password of the wifi list
+     * @return Request handle
+     */
+HaCConnectHandle HaCWifiManager::connectAsync(const char *ssid, const char *pass)
+{
+     t_connectRequest request;
+     request.type = REQUEST_CONNECT;
+     strncpy(request.ssid, ssid, sizeof(request.ssid) - 1);
+     if (pass)
+     {
+          strncpy(request.pass, pass, sizeof(request.pass) - 1);
+          request.hasPass = true;
+     }
+     return this->_queueConnectRequest(request);
+}
+
+/**
+     * Request a disconnection of the station.
+     * Note: The station stays down until the next connect request or setup.
+     * @return Request handle
+     */
+HaCConnectHandle HaCWifiManager::disconnectAsync()
+{
+     t_connectRequest request;
+     request.type = REQUEST_DISCONNECT;
+     return this->_queueConnectRequest(request);
+}
+
+/**
+     * Getting a consistent copy of the manager status.
+     * Note: The status is published by the manager loop, reading it takes no lock and
+     * no SDK call so it may be called from any task or core.
+     * @param status Status copy
+     * @return True if a consistent copy was read, else the status is left unchanged
+     */
+bool HaCWifiManager::getStatus(t_wifiStatus &status)
+{
+     return this->_status.read(status);
+}
+
+/**
+     * Getting the status sequence, it changes on every status update.
+     * @return Status sequence
+     */
+uint32_t HaCWifiManager::getStatusSequence()
+{
+     return this->_status.sequence();
+}
+
+/**
+     * Setting the timeout of a single connection attempt.
+     * Note: When an attempt times out or fails authentication the next ranked candidate is tried.
+     * @param timeoutMs Connection attempt timeout in millisecond.
+     */
+void HaCWifiManager::setConnectAttemptTimeout(unsigned long timeoutMs)
+{
+     this->_connectAttemptTimeoutMs = timeoutMs;
+}
+
+/**
+     * Setting the reconnect backoff.
+     * Note: Rescan and retry after a failure are delayed by an exponential backoff with
+     * decorrelated jitter seeded from the device mac address.
+     * @param baseMs Minimum reconnect delay in millisecond.
+     * @param capMs Maximum reconnect delay in millisecond.
+     */
+void HaCWifiManager::setReconnectBackoff(unsigned long baseMs, unsigned long capMs)
+{
+     this->_reconnectBackoff = HaCBackoff(baseMs, capMs);
+     this->_seedReconnectBackoff();
+}
+
+/**
+     * Setting the adaptive station watchdog.
+     * Note: The watchdog deadline of a network is learned from its observed time to IP
+     * as mean + k * stddev, bounded by the floor and the ceiling.
+     * @param floorMs Minimum watchdog deadline in millisecond.
+     * @param ceilingMs Maximum watchdog deadline in millisecond.
+     * @param k Number of standard deviation added to the mean.
+     */
+void HaCWifiManager::setConnectWatchdog(unsigned long floorMs, unsigned long ceilingMs, float k)
+{
+     this->_watchdogFloorMs = floorMs;
+     this->_watchdogCeilingMs = ceilingMs < floorMs ? floorMs : ceilingMs;
+     this->_watchdogK = k;
+}
+
+/**
+     * Setting the IP acquisition timeout of a connection attempt.
+     * Note: Starts once the station is associated, applies on DHCP network only.
+     * @param timeoutMs Time to get an IP before the DHCP is restarted.
+     * @param maxRestart DHCP restarts before moving to the next candidate.
+     */
+void HaCWifiManager::setDhcpTimeout(unsigned long timeoutMs, uint8_t maxRestart)
+{
+     this->_dhcpTimeoutMs = timeoutMs;
+     this->_dhcpMaxRestart = maxRestart;
+}
+
+/**
+     * Setting the DHCP lease reuse.
+     * Note: The last lease of a network is configured statically on reconnect which saves
+     * the DHCP handshake. The lease is discarded if the gateway does not answer or another host
+     * holds the address, otherwise DHCP takes it over in the background.
+     * A lease is not reused past the lease time granted by the DHCP server.
+     * @param enable Enable lease reuse flag.
+     * @param maxAgeMs Remembered lease older than this is not reused.
+     */
+void HaCWifiManager::setLeaseReuse(bool enable, unsigned long maxAgeMs)
+{
+     this->_leaseReuseEnable = enable;
+     this->_leaseMaxAgeMs = maxAgeMs;
+
+     this->_leaseVerifyTimer = Tick(LEASE_VERIFY_TIMEOUT, this->_timers);
+     this->_leaseVerifyTimer.onTick([&]()
+                                    {
+                                         this->_verifyLease();
+                                    });
+     this->_leaseRenewTimer = Tick(LEASE_RENEW_POLL, this->_timers);
+     this->_leaseRenewTimer.onTick([&]()
+                                   {
+                                        this->_renewLease();
+                                   });
+}
+
+/**
+     * Getting the DHCP lease reuse enable flag.
+     * @return Lease reuse enable flag
+     */
+bool HaCWifiManager::getLeaseReuse()
+{
+     return this->_leaseReuseEnable;
+}
+
+/**
+     * Getting the station watchdog deadline of a network.
+     * @param ssid Network ssid
+     * @return Watchdog deadline in millisecond
+     */
+unsigned long HaCWifiManager::getConnectDeadline(const char *ssid)
+{
+     return this->_connectDeadline(ssid, false);
+}
+
+/**
+     * Setting background scan while the station is connected.
+     * Note: The background scan keeps a ranked fallback list of the known networks,
+     * on disconnect the station jumps to the strongest candidate without scanning.
+     * Applies on multi wifi only.
+     * @param enable Enable background scan flag.
+     * @param intervalMs Background scan period in millisecond.
+     */
+void HaCWifiManager::setBackgroundScan(bool enable, unsigned long intervalMs)
+{
+     this->_bgScanEnable = enable;
+     this->_bgScanIntervalMs = intervalMs;
+
+     this->_bgScanTimer = Tick(this->_bgScanIntervalMs, this->_timers);
+     this->_bgScanTimer.onTick([&]()
+                               {
+                                    this->_startBackgroundScan();
+                               });
+     if(enable && this->_staState.state() == STA_CONNECTED)
+          this->_bgScanTimer.begin();
+
+     if(!enable) this->_fallbackList.clear();
+}
+
+/**
+     * Getting background scan enable flag.
+     * @return Background scan enable flag
+     */
+bool HaCWifiManager::getBackgroundScan()
+{
+     return this->_bgScanEnable;
+}
+
+/**
+     * Setting proactive roaming while the station is connected.
+     * Note: Roaming picks its candidates from the scan cache, hence it requires a scan cache TTL.
+     * @param enable Enable roaming flag.
+     * @param rssiThreshold Rssi in dBm below which a better access point is looked for.
+     * @param hysteresisDb Minimum rssi gain in dB required to switch.
+     * @param dwellMs Minimum time on an access point before roaming away.
+     * @param sampleMs Rssi sampling period in millisecond.
+     */
+void HaCWifiManager::setRoaming(bool enable, int8_t rssiThreshold, uint8_t hysteresisDb,
+                                unsigned long dwellMs, unsigned long sampleMs)
+{
+     this->_roamEnable = enable;
+     this->_roamRssiThreshold = rssiThreshold;
+     this->_roamHysteresisDb = hysteresisDb;
+     this->_roamDwellMs = dwellMs;
+     this->_roamLowCount = 0;
+
+     this->_roamTimer = Tick(sampleMs, this->_timers);
+     this->_roamTimer.onTick([&]()
+                             {
+                                  this->_handleRoaming();
+                             });
+     if(enable && this->_staState.state() == STA_CONNECTED)
+          this->_roamTimer.begin();
+}
+
+/**
+     * Getting roaming enable flag.
+     * @return Roaming enable flag
+     */
+bool HaCWifiManager::getRoaming()
+{
+     return this->_roamEnable;
+}
+
+/**
+     * Getting the station connection state.
+     * @return Station state
+     */
+StationState HaCWifiManager::getStationState()
+{
+     return this->_staState.state();
+}
+
+/**
+     * Getting the time spent on the current station state.
+     * @return Time in state in millisecond
+     */
+unsigned long HaCWifiManager::getTimeInState()
+{
+     return this->_staState.timeInState();
+}
+
+/**
+     * Getting the time until the library loop has work to do.
+     * Note: The loop may be paused up to this time, on light sleep for instance, but must also
+     * run on any wifi event. The onSTALoop and onAPLoop events are only raised when the loop runs.
+     * On task mode the application gets the time until an event is queued or one of its own
+     * timers is due, the manager task sleeps on its own.
+     * @return Time in millisecond, 0 if the loop has pending work, TICK_NO_DEADLINE if no timer
+     * is armed
+     */
+unsigned long HaCWifiManager::nextWakeupMs()
+{
+     #ifdef HAC_TASK_SUPPORT
+     if (this->_taskMode && !this->_isTaskContext())
+          return this->_eventRing && !this->_eventRing->empty() ? 0 : this->_appWakeupMs();
+     #endif
+
+     //Work left for the next loop
+     if (this->_scanDoneFlag || this->_savePending) return 0;
+     if (this->_connectRing && !this->_connectRing->empty()) return 0;
+     if (this->_deferEvents && this->_eventRing && !this->_eventRing->empty()) return 0;
+     if (this->_apFlagStarted != this->_onReadyStateAPFlagOnce) return 0;
+
+     wl_status_t status = WiFi.status();
+     StationState state = this->_staState.state();
+     if ((state == STA_CONNECTED) != (status == WL_CONNECTED)) return 0;
+
+     unsigned long wakeup = this->_timers.timeToNext();
+     unsigned long wakeupUs = this->_timersUs.timeToNext();
+     if (wakeupUs != TICK_NO_DEADLINE && wakeupUs / 1000 < wakeup) wakeup = wakeupUs / 1000;
+     //Application timers are fired by loop(), on task mode they do not wake the manager task
+     if (!this->_taskMode)
+     {
+          unsigned long appWakeup = this->_appWakeupMs();
+          if (appWakeup < wakeup) wakeup = appWakeup;
+     }
+
+     //Pending waits of the connection flows
+     unsigned long flowWakeup = this->_setupFlow.timeToTimeout();
+     if (flowWakeup < wakeup) wakeup = flowWakeup;
+     flowWakeup = this->_attemptFlow.timeToTimeout();
+     if (flowWakeup < wakeup) wakeup = flowWakeup;
+
+     if (this->_staState.isConnecting())
+     {
+          if (state == STA_ASSOCIATING && this->_staAssociated) return 0;
+          if (state == STA_DHCP && !this->_staAssociated) return 0;
+
+          //A failure status is acted on once the attempt grace period is over
+          if (status == WL_CONNECT_FAILED ||
+          #ifdef ESP8266
+              status == WL_WRONG_PASSWORD ||
+          #endif
+              status == WL_NO_SSID_AVAIL)
+          {
+               unsigned long elapsed = millis() - this->_staAttemptStart;
+               if (elapsed >= CONNECT_ABORT_GRACE) return 0;
+               if (CONNECT_ABORT_GRACE - elapsed < wakeup) wakeup = CONNECT_ABORT_GRACE - elapsed;
+          }
+     }
+
+     #ifdef ESP8266
+     if (this->_initMdnsFlagOnce && wakeup > MDNS_SERVICE_INTERVAL) wakeup = MDNS_SERVICE_INTERVAL;
+     #endif
+
+     return wakeup;
+}
+
+/**
+     * Getting the time until an application timer of the shared schedulers is due.
+     * @return Time in millisecond, TICK_NO_DEADLINE if no timer is armed
+     */
+unsigned long HaCWifiManager::_appWakeupMs()
+{
+     unsigned long wakeup = TickScheduler::instance().timeToNext();
+     unsigned long wakeupUs = TickSchedulerUs::instance().timeToNext();
+     if (wakeupUs != TICK_NO_DEADLINE && wakeupUs / 1000 < wakeup) wakeup = wakeupUs / 1000;
+     return wakeup;
+}
+
+/**
+     * Getting the reason code of the last station disconnect.
+     * @return SDK disconnect reason code, 0 if unknown
+     */
+uint8_t HaCWifiManager::getLastDisconnectReason()
+{
+     return this->_lastDisconnectReason;
+}
+
+/**
+     * Getting the quarantine state of a network.
+     * Note: An expired quarantine is released on this call.
+     * @param ssid Network ssid
+     * @return True if the network is quarantined else False
+     */
+bool HaCWifiManager::isQuarantined(const char *ssid)
+{
+     t_networkStats *stats = this->_networkStats.get(ssid, false);
+     if (!stats || !stats->quarantined) return false;
+
+     if ((long)(millis() - stats->quarantineUntil) >= 0)
+     {
+          //Failures start counting again, the quarantine level is kept until a successful connection
+          stats->quarantined = false;
+          return false;
+     }
+     return true;
+}
+
+/**
+     * Getting the remaining quarantine time of a network.
+     * @param ssid Network ssid
+     * @return Remaining quarantine time in millisecond, 0 if not quarantined
+     */
+unsigned long HaCWifiManager::getQuarantineRemaining(const char *ssid)
+{
+     if (!this->isQuarantined(ssid)) return 0;
+     return this->_networkStats.get(ssid, false)->quarantineUntil - millis();
+}
+
+/**
+     * Release the quarantine of a network e.g. once its credential has been corrected.
+     * @param ssid Network ssid
+     */
+void HaCWifiManager::releaseQuarantine(const char *ssid)
+{
+     t_networkStats *stats = this->_networkStats.get(ssid, false);
+     if (!stats) return;
+
+     stats->quarantined = false;
+     stats->authFailures = 0;
+     stats->quarantineLevel = 0;
+}
+
+/**
+     * Setting throughput sensitive flag.
+     * Note: Background scan is paused while the application is throughput sensitive.
+     * @param sensitive Throughput sensitive flag.
+     */
+void HaCWifiManager::setThroughputSensitive(bool sensitive)
+{
+     this->_throughputSensitive = sensitive;
+}
+
+/**
+     * Getting throughput sensitive flag.
+     * @return Throughput sensitive flag
+     */
+bool HaCWifiManager::getThroughputSensitive()
+{
+     return this->_throughputSensitive;
+}
+
+/**
+     * Getting the number of fallback candidates from the last background scan.
+     * @return Fallback candidates count
+     */
+uint8_t HaCWifiManager::getFallbackListCount()
+{
+     return this->_fallbackList.size();
+}
+
+/**
+     * Setting the time to live of the scan cache.
+     * Note: Reconnect attempts within the time to live reuse the cached scan instead of scanning.
+     * @param ttlMs Time to live in millisecond, 0 disables the scan cache.
+     */
+void HaCWifiManager::setScanCacheTTL(unsigned long ttlMs)
+{
+     this->_scanCache.setTTL(ttlMs);
+}
+
+/**
+     * Getting the scan cache.
+     * Note: Iterating the cache only visits the entries within the time to live and never triggers a scan.
+     * @return Scan cache
+     */
+const HaCScanCache &HaCWifiManager::getScanCache()
+{
+     return this->_scanCache;
 }
 
 /**
@@ -491,6 +1076,27 @@ bool HaCWifiManager::editWifiList(const char *oldSsid, const char *oldPass,
      return this->_wifiParam->editWifiList(oldSsid, oldPass, newSsid, newPass);
 }
 
+/**
+     * Setting the network profile of a wifi from the wifi list
+     * Note: The profile is applied when the wifi is selected for connection.
+     * @param ssid Wifi SSID
+     * @param profile Network profile, PROFILE_DEFAULT uses the global station network
+     * @param ip Static ip, used on PROFILE_STATIC only
+     * @param sn Static subnet mask, used on PROFILE_STATIC only
+     * @param gw Static gateway, used on PROFILE_STATIC only
+     * @param pdns Static primary dns, used on PROFILE_STATIC only
+     * @param sdns Static secondary dns, used on PROFILE_STATIC only
+     * @return True if the wifi exists else False
+     */
+bool HaCWifiManager::setWifiNetworkProfile(const char *ssid, NetworkProfile profile,
+                                           const char *ip, const char *sn, const char *gw,
+                                           const char *pdns, const char *sdns)
+{
+     if(!this->_wifiParam)return false;
+
+     return this->_wifiParam->setWifiNetworkProfile(ssid, profile, ip, sn, gw, pdns, sdns);
+}
+
 /**
      * Removing wifi info from wifi list info
      * @param ssid Wifi SSID        
@@ -507,6 +1113,10 @@ bool HaCWifiManager::removeWifiList(const char *ssid)
      */
 void HaCWifiManager::shutdownSTA()
 {
+     if (this->_connectOp.id && this->_connectOp.result == CONNECT_PENDING)
+          this->_completeConnectRequest(CONNECT_CANCELLED);
+     this->_stopStation();
+
      WiFi.disconnect();
      WiFi.mode(WIFI_OFF);
 
@@ -516,11 +1126,25 @@ void HaCWifiManager::shutdownSTA()
 }
 
 /**
-     * Shutdown Wifi Access Point.          
+     * Stop the station connection pipeline.
      */
-void HaCWifiManager::shutdownAP()
+void HaCWifiManager::_stopStation()
 {
-     WiFi.softAPdisconnect(true);
+     //Station events are raised before the station goes down
+     if (this->_staState.state() == STA_CONNECTED) this->_onStationDisconnected(false);
+     this->_setStaState(STA_IDLE);
+     this->_setupFlow.stop();
+     this->_attemptFlow.stop();
+     this->_reconnectTimer.stop();
+}
+
+/**
+     * Shutdown Wifi Access Point.          
+     */
+void HaCWifiManager::shutdownAP()
+{
+     this->_apStartupTimer.stop();
+     WiFi.softAPdisconnect(true);
      this->_apFlagStarted = false;
 }
 
@@ -585,76 +1209,50 @@ void HaCWifiManager::setWifiOptions(bool persistent,
      */
 void HaCWifiManager::loop()
 {
-     //Wifi Station onReady event
-     if (WiFi.status() == WL_CONNECTED && !this->_onReadyStateSTAFlagOnce)
+     //On task mode the manager runs on its own task, the loop delivers its events
+     if (this->_taskMode)
      {
-          if (this->_onSTAReadyFn)
-               this->_onSTAReadyFn(WiFi.SSID().c_str());
-          this->_onReadyStateSTAFlagOnce = true;
-
-          //Initialize MDNS once
-          if(!this->_initMdnsFlagOnce)
-          {
-               char hostName[30];
-               memset(hostName, '\0', 30);
-               strcpy(hostName, this->getHostName());
-               //If host name is empty then set the default hostname
-               if(hostName[0] == '\0') strcpy(hostName, DEFAULT_HOST_NAME);
-
-               if(MDNS.begin(hostName))
-               {
-                    DEBUG_CALLBACK_HAC(F("MDNS Started."));
-                    DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG116, hostName);
-                    this->_initMdnsFlagOnce = true;
-               }
-               else
-               {
-                    DEBUG_CALLBACK_HAC(F("MDNS failed to start."));
-                    this->_printError(23);
-               }              
-          }
-          //Saving to file
-          this->_save();
-
-          //Destroying parameters
-          if(this->_wifiParam)
-          {
-               DEBUG_CALLBACK_HAC(F("Destroying wifi parameters.."));
-               delete this->_wifiParam;
-          }
-
+          this->_dispatchEvents(this->_eventDispatchLimit);
+          //Application timers stay on the application task
+          TickScheduler::instance().handle();
+          TickSchedulerUs::instance().handle();
+          return;
      }
-     //Wifi station onDisconnect event
-     if (WiFi.status() != WL_CONNECTED && this->_onReadyStateSTAFlagOnce)
-     {
-          //this->_initParam();
-
-          if (this->_onSTADisconnectFn)
-               this->_onSTADisconnectFn(WiFi.SSID().c_str());
-          this->_onReadyStateSTAFlagOnce = false;
+     this->_loopCore();
 
-          //Set the rssi for the current ssid to the lowest dbM value
-          //in order to put it lowest on the new scanning
-          this->_wifiParam->wifiInfo[0].rssi = -127;
+     //Deferred events are delivered once the manager step is done
+     if (this->_deferEvents) this->_dispatchEvents(this->_eventDispatchLimit);
+     //Application timers on the shared scheduler
+     TickScheduler::instance().handle();
+     TickSchedulerUs::instance().handle();
+}
 
-          //if multiwifi is enabled then reinitialized the wifi multimode setup
-          if (this->_wifiParam->getEnableMultiWifi())
-               this->_setupSTAMultiWifi();
+/**
+     * Manager loop, run by the application loop or by the manager task.
+     */
+void HaCWifiManager::_loopCore()
+{
+     this->_loopStartUs = micros();
 
-          
-     }
-     //Wifi onSTATLoop event
-     if (this->_onReadyStateSTAFlagOnce)
+     //Station status is read once per loop and dispatched on the station state
+     wl_status_t status = WiFi.status();
+     switch (this->_staState.state())
      {
-          //TO DO: Pass json data for the status of the STA
-          if (this->_onSTALoopFn)
-               this->_onSTALoopFn("");
-          
-          //If MDNS initialized, then start MDNS loop
-          #ifdef ESP8266
-          if(this->_initMdnsFlagOnce) MDNS.update();  
-          #endif
+     case STA_CONNECTED:
+          if (status != WL_CONNECTED) this->_onStationDisconnected();
+          else this->_onStationLoop();
+          break;
+     default:
+          //Station may also be reconnected by the SDK itself, unless a disconnect is requested
+          if (status == WL_CONNECTED && !this->_disconnectRequested) this->_onStationReady();
+          break;
      }
+     //Connect and disconnect requests of the application
+     this->_runConnectRequests(status);
+     //Station connection flows, each step runs on the loop its event is seen
+     this->_runSetupFlow();
+     this->_runAttemptFlow(status);
+
      //Access point onReady event
      if (this->_apFlagStarted && !this->_onReadyStateAPFlagOnce)
      {
@@ -663,399 +1261,2149 @@ void HaCWifiManager::loop()
           {
                DEBUG_CALLBACK_HAC(F("Destroying wifi parameters.."));
                delete this->_wifiParam;
+               this->_wifiParam = nullptr;
           }
 
           this->_onReadyStateAPFlagOnce = true;          
-          if (this->_onAPReadyFn)
-               this->_onAPReadyFn(WiFi.softAPSSID().c_str());
+          this->_statusDirty = true;
+          this->_statusTimer.begin();
+          this->_raiseEvent(HAC_EVENT_AP_READY, WiFi.softAPSSID().c_str());
      }
      //Access point onDisconnect event
      if (!this->_apFlagStarted && this->_onReadyStateAPFlagOnce)
      {
           //this->_initParam();
           this->_onReadyStateAPFlagOnce = false;          
-          if (this->_onAPDisconnectFn)
-               this->_onAPDisconnectFn(WiFi.softAPSSID().c_str());
+          this->_statusDirty = true;
+          this->_raiseEvent(HAC_EVENT_AP_DISCONNECT, WiFi.softAPSSID().c_str());
      }
      //Access point onAPLoop event
      if (this->_onReadyStateAPFlagOnce)
      {          
-          if (this->_onAPLoopFn)
+          if (this->_onAPLoopFn && !this->_isEventQueued(HAC_EVENT_AP_READY))
                this->_onAPLoopFn("");
+
+          //Access point new client connection event
+          uint8_t clientCount = WiFi.softAPgetStationNum();
+          if(clientCount != this->_previousAPClientCount)
+          {
+               this->_previousAPClientCount = clientCount;
+               this->_statusDirty = true;
+               //TO DO: Pass json data for the status of the STA
+               this->_raiseEvent(HAC_EVENT_AP_NEW_CONNECTION, String("{\"no_client\": " + String(clientCount) + "}").c_str());
+          }
      }
-     //Access point new client connection event
-     if(WiFi.softAPgetStationNum() != this->_previousAPClientCount)
+
+     //Scan done event, the station setup scan is consumed by the setup flow
+     if(this->_scanDoneFlag && this->_staState.state() != STA_SCANNING)
      {
-          this->_previousAPClientCount = WiFi.softAPgetStationNum();
-          //TO DO: Pass json data for the status of the STA
-          if (this->_onAPNewConnectionFn)
-               this->_onAPNewConnectionFn(String("{\"no_client\": " + String(WiFi.softAPgetStationNum()) + "}").c_str());
+          this->_scanDoneFlag = false;
+          if(this->_bgScanRunning) this->_handleBackgroundScan();
+     }
+     //Manager timers, only the earliest deadline is checked
+     this->_timers.handle();
+     this->_timersUs.handle();
 
+     //Deferred work runs last, on what the manager step left of the budget
+     this->_runDeferredWork();
+
+     if (this->_statusDirty) this->_publishStatus();
+
+     //Loop budget statistics
+     unsigned long elapsedUs = micros() - this->_loopStartUs;
+     this->_loopStats.calls++;
+     this->_loopStats.lastUs = elapsedUs;
+     if (elapsedUs > this->_loopStats.maxUs) this->_loopStats.maxUs = elapsedUs;
+     if (this->_loopBudgetUs && elapsedUs > this->_loopBudgetUs)
+     {
+          this->_loopStats.overruns++;
+          this->_loopStats.overrunUs += elapsedUs - this->_loopBudgetUs;
      }
-     //All timers
-     this->_wifiScanTimer.handle();
-     this->_staStartupTimer.handle();
-     this->_staWatchdogTimer.handle();
 }
 
 /**
-     * Debug Callback function.           
-     * @param fn Standard non return function with a const * char parameter.
+     * Run the work deferred from a previous loop pass, after the manager step.
+     * Note: The save is not sliced as the file is written at once, it waits for a loop
+     * pass with its learned cost left in the budget, at most LOOP_BUDGET_MAX_DEFER passes.
      */
+void HaCWifiManager::_runDeferredWork()
+{
+     if (!this->_savePending) return;
 
-void HaCWifiManager::onDebug(tListGenCbFnHaC1StrParamSub fn)
+     if (!this->_hasBudget(this->_saveCostUs) && this->_saveDeferCount < LOOP_BUDGET_MAX_DEFER)
+     {
+          this->_saveDeferCount++;
+          this->_loopStats.deferred++;
+          return;
+     }
+
+     unsigned long startUs = micros();
+     this->_savePending = false;
+     this->_saveDeferCount = 0;
+     this->_save();
+     unsigned long costUs = micros() - startUs;
+     if (costUs > this->_saveCostUs) this->_saveCostUs = costUs;
+
+     //Destroying parameters
+     //Note: Parameters are kept while background scan or roaming is enabled as the
+     //candidates are ranked against the wifi list
+     if(this->_wifiParam && this->_staState.state() == STA_CONNECTED &&
+        !this->_bgScanEnable && !this->_roamEnable)
+     {
+          DEBUG_CALLBACK_HAC(F("Destroying wifi parameters.."));
+          delete this->_wifiParam;
+          this->_wifiParam = nullptr;
+     }
+}
+
+/**
+     * Checking if the current loop pass has budget left.
+     * @param costUs Expected cost of the next work in microsecond
+     * @return True if the work fits the budget or no budget is set else False
+     */
+bool HaCWifiManager::_hasBudget(unsigned long costUs)
 {
-     this->_onDebugFn = fn;
+     if (this->_loopBudgetUs == 0) return true;
+     return micros() - this->_loopStartUs + costUs <= this->_loopBudgetUs;
 }
 
 /**
-     * On Error Callback function.           
-     * @param fn Standard non return function with a const * char parameter.
+     * Setting the time budget of a loop call.
+     * Note: Long operations are split into slices resumed on the next loop calls once the
+     * budget is spent. The budget is a target, a slice which started always completes.
+     * @param budgetUs Budget in microsecond, 0 for no budget
      */
+void HaCWifiManager::setLoopBudget(unsigned long budgetUs)
+{
+     this->_loopBudgetUs = budgetUs;
+}
 
-void HaCWifiManager::onError(tListGenCbFnHaC1StrParamSub fn)
+/**
+     * Getting the time budget of a loop call.
+     * @return Budget in microsecond, 0 if no budget
+     */
+unsigned long HaCWifiManager::getLoopBudget()
 {
-     this->_onErrorFn = fn;
+     return this->_loopBudgetUs;
 }
 
 /**
-     * On Ready Callback function.           
-     * @param fn Standard non return function with a const * char parameter.
+     * Getting the loop call statistics.
+     * @return Loop statistics
      */
+const t_loopStats &HaCWifiManager::getLoopStats()
+{
+     return this->_loopStats;
+}
 
-void HaCWifiManager::onSTAReady(tListGenCbFnHaC1StrParamSub fn)
+/**
+     * Reset the loop call statistics.
+     */
+void HaCWifiManager::resetLoopStats()
 {
-     this->_onSTAReadyFn = fn;
+     this->_loopStats = t_loopStats();
 }
 
 /**
-     * On Disconnect Callback function.           
-     * @param fn Standard non return function with a const * char parameter.
+     * Run the manager on its own task.
+     * Note: Available on ESP32 only. The manager has to be set up before, and configured
+     * only while the task is stopped. The manager timers and callbacks run on the task,
+     * the application loop keeps calling loop() which then delivers the manager events
+     * and runs the application timers.
+     * @param core Core the task is pinned to, ESP32 only
+     * @param stackSize Task stack size in bytes, ESP32 only
+     * @param priority Task priority, ESP32 only
+     * @return True if the task started else False
      */
+bool HaCWifiManager::beginTask(uint8_t core, uint32_t stackSize, uint8_t priority)
+{
+     #ifdef HAC_TASK_SUPPORT
+     if (this->_taskMode) return true;
 
-void HaCWifiManager::onSTADisconnect(tListGenCbFnHaC1StrParamSub fn)
+     if (!this->_eventRing) this->_eventRing = new HaCSpscRing<t_hacEvent, HAC_EVENT_QUEUE_SIZE>();
+     //Loop events follow the state delivered to the application from now on
+     if (!this->_deferEvents)
+     {
+          this->_appStaReady = this->_staState.state() == STA_CONNECTED;
+          this->_appApReady = this->_onReadyStateAPFlagOnce;
+     }
+     //Requests of the application are queued to the task
+     if (!this->_connectRing) this->_connectRing = new HaCSpscRing<t_connectRequest, HAC_CONNECT_QUEUE_SIZE>();
+     //The snapshot is current before the task becomes its only writer
+     this->_publishStatus();
+     this->_taskStop = false;
+     this->_taskRunning = true;
+     this->_taskMode = true;
+     if (xTaskCreatePinnedToCore(HaCWifiManager::_taskEntry, "hacwfm", stackSize, this,
+                                 priority, &this->_taskHandle, core) != pdPASS)
+     {
+          this->_taskMode = false;
+          this->_taskRunning = false;
+          DEBUG_CALLBACK_HAC(F("Manager task failed to start."));
+          return false;
+     }
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG138, core);
+     return true;
+     #else
+     DEBUG_CALLBACK_HAC(F("Task mode is not supported on this platform."));
+     return false;
+     #endif
+}
+
+/**
+     * Stop the manager task, the manager is run by loop() again.
+     */
+void HaCWifiManager::endTask()
 {
-     this->_onSTADisconnectFn = fn;
+     #ifdef HAC_TASK_SUPPORT
+     if (!this->_taskMode) return;
+
+     this->_taskStop = true;
+     while (this->_taskRunning) delay(1);
+     this->_taskHandle = nullptr;
+     //Events left are delivered before going back to the direct callbacks
+     this->_dispatchEvents();
+     this->_taskMode = false;
+     #endif
 }
 
 /**
-     * On Station mode Loop Callback function.           
-     * @param fn Standard non return function with a const * char parameter.
+     * Checking if the manager runs on its own task.
+     * @return True on task mode else False
      */
+bool HaCWifiManager::isTaskMode()
+{
+     return this->_taskMode;
+}
 
-void HaCWifiManager::onSTALoop(tListGenCbFnHaC1StrParamSub fn)
+/**
+     * Getting the number of events lost as the event queue was full.
+     * @return Dropped event count
+     */
+unsigned long HaCWifiManager::getDroppedEvents()
 {
-     this->_onSTALoopFn = fn;
+     return this->_eventsDropped.load(std::memory_order_relaxed);
 }
 
 /**
-     * On AP ready Callback function.           
-     * @param fn Standard non return function with a const * char parameter.
+     * Setting the deferred event dispatch.
+     * Note: Station and access point events are queued with their raise time and
+     * delivered once the manager step of loop() is done, so a slow callback does not
+     * delay the manager timers. Debug and error events are still delivered at once.
+     * Events are dropped if more than HAC_EVENT_QUEUE_SIZE are waiting.
+     * @param enable True to defer the events
+     * @param maxPerLoop Events delivered per loop call, 0 for no limit
      */
+void HaCWifiManager::setDeferredEvents(bool enable, uint8_t maxPerLoop)
+{
+     this->_eventDispatchLimit = maxPerLoop;
+     if (enable == this->_deferEvents) return;
 
-void HaCWifiManager::onAPReady(tListGenCbFnHaC1StrParamSub fn)
+     if (enable)
+     {
+          if (!this->_eventRing) this->_eventRing = new HaCSpscRing<t_hacEvent, HAC_EVENT_QUEUE_SIZE>();
+          this->_appStaReady = this->_staState.state() == STA_CONNECTED;
+          this->_appApReady = this->_onReadyStateAPFlagOnce;
+          this->_deferEvents = true;
+          return;
+     }
+     //Events left are delivered before going back to the direct callbacks
+     if (!this->_taskMode) this->_dispatchEvents();
+     this->_deferEvents = false;
+}
+
+/**
+     * Getting the deferred event dispatch.
+     * @return True if the events are deferred else False
+     */
+bool HaCWifiManager::getDeferredEvents()
 {
-     this->_onAPReadyFn = fn;
+     return this->_deferEvents;
 }
 
 /**
-     * On AP disconnect Callback function.           
-     * @param fn Standard non return function with a const * char parameter.
+     * Getting the event queue statistics.
+     * @return Event queue statistics
      */
+t_eventStats HaCWifiManager::getEventStats()
+{
+     t_eventStats stats = this->_eventStats;
+     stats.queued = this->_eventsQueued.load(std::memory_order_relaxed);
+     stats.dropped = this->_eventsDropped.load(std::memory_order_relaxed);
+     stats.maxDepth = this->_eventsMaxDepth.load(std::memory_order_relaxed);
+     return stats;
+}
 
-void HaCWifiManager::onAPDisconnect(tListGenCbFnHaC1StrParamSub fn)
+/**
+     * Reset the event queue statistics.
+     */
+void HaCWifiManager::resetEventStats()
 {
-     this->_onAPDisconnectFn = fn;
+     this->_eventStats = t_eventStats();
+     this->_eventsQueued.store(0, std::memory_order_relaxed);
+     this->_eventsDropped.store(0, std::memory_order_relaxed);
+     this->_eventsMaxDepth.store(0, std::memory_order_relaxed);
 }
 
 /**
-     * On AP mode Loop Callback function.           
-     * @param fn Standard non return function with a const * char parameter.
+     * Getting the raise time of the event being delivered.
+     * Note: Callbacks of queued events may use it to tell how late they run.
+     * @return millis() when the event was raised, the current time if the event is not queued
      */
+unsigned long HaCWifiManager::getEventTime()
+{
+     return this->_eventTime ? this->_eventTime : millis();
+}
 
-void HaCWifiManager::onAPLoop(tListGenCbFnHaC1StrParamSub fn)
+/**
+     * Deliver the queued events, on the application loop.
+     * @param limit Events delivered, 0 for no limit
+     */
+void HaCWifiManager::_dispatchEvents(uint8_t limit)
 {
-     this->_onAPLoopFn = fn;
+     t_hacEvent event;
+     if (this->_eventRing) this->_eventStats.depth = this->_eventRing->size();
+     uint8_t count = 0;
+     while (this->_eventRing && (!limit || count < limit) && this->_eventRing->pop(event))
+     {
+          count++;
+          if (event.type == HAC_EVENT_STA_READY) this->_appStaReady = true;
+          else if (event.type == HAC_EVENT_STA_DISCONNECT) this->_appStaReady = false;
+          else if (event.type == HAC_EVENT_AP_READY) this->_appApReady = true;
+          else if (event.type == HAC_EVENT_AP_DISCONNECT) this->_appApReady = false;
+
+          unsigned long delayMs = millis() - event.timestamp;
+          if (delayMs > this->_eventStats.maxDelayMs) this->_eventStats.maxDelayMs = delayMs;
+          this->_eventStats.dispatched++;
+          this->_eventTime = event.timestamp;
+          this->_callEvent(event.type, event.data);
+          this->_eventTime = 0;
+     }
+
+     //Loop events follow the state delivered to the application
+     if (this->_appStaReady && this->_onSTALoopFn) this->_onSTALoopFn("");
+     if (this->_appApReady && this->_onAPLoopFn) this->_onAPLoopFn("");
 }
 
 /**
-     * AP new connection Callback function.           
-     * @param fn Standard non return function with a const * char parameter.
+     * Checking if an event is queued instead of being delivered at once.
+     * Note: On task mode only the manager task may push to the queue.
+     * @param type Event type
+     * @return True if the event is queued else False
      */
+bool HaCWifiManager::_isEventQueued(HaCEventType type)
+{
+     #ifdef HAC_TASK_SUPPORT
+     if (this->_taskMode) return this->_isTaskContext();
+     #endif
+     return this->_deferEvents && type != HAC_EVENT_DEBUG && type != HAC_EVENT_ERROR;
+}
 
-void HaCWifiManager::onAPNewConnection(tListGenCbFnHaC1StrParamSub fn)
+/**
+     * Publish the manager status snapshot.
+     * Note: Only the manager loop writes the snapshot, the SDK is read here once
+     * instead of on every getter call.
+     */
+void HaCWifiManager::_publishStatus()
 {
-     this->_onAPNewConnectionFn = fn;
+     t_wifiStatus status;
+     this->_statusDirty.store(false);
+     status.state = this->_staState.state();
+     status.staConnected = status.state == STA_CONNECTED;
+     status.apStarted = this->_onReadyStateAPFlagOnce;
+     status.updatedAt = millis();
+
+     if (status.staConnected)
+     {
+          strncpy(status.ssid, WiFi.SSID().c_str(), sizeof(status.ssid) - 1);
+          memcpy(status.bssid, WiFi.BSSID(), 6);
+          status.channel = WiFi.channel();
+          status.rssi = WiFi.RSSI();
+          status.staIp = WiFi.localIP();
+          status.staSubnet = WiFi.subnetMask();
+          status.staGateway = WiFi.gatewayIP();
+          #ifdef ESP8266
+          status.dns1 = dns_getserver(1)->addr;
+          status.dns2 = dns_getserver(2)->addr;
+          #endif
+          #ifdef ESP32
+          status.dns1 = dns_getserver(1)->u_addr.ip4.addr;
+          status.dns2 = dns_getserver(2)->u_addr.ip4.addr;
+          #endif
+          status.staConnectedAt = this->_connectedSince;
+     }
+
+     if (status.apStarted)
+     {
+          __TCP_INFO__ info;
+          __TCP_ADAPTER_GET_IP_INFO(__TCP_ADAPTER_INTERFACE__, &info);
+          strncpy(status.apSsid, WiFi.softAPSSID().c_str(), sizeof(status.apSsid) - 1);
+          status.apIp = info.ip.addr;
+          status.apSubnet = info.netmask.addr;
+          status.apGateway = info.gw.addr;
+          status.apClients = this->_previousAPClientCount;
+     }
+     this->_status.write(status);
+
+     //Nothing left to refresh while both interfaces are down
+     if (!status.staConnected && !status.apStarted) this->_statusTimer.stop();
 }
 
 /**
- * Debug function.
- * @param data Debug message .
- */
-void HaCWifiManager::_debug(const __FlashStringHelper* data)
+     * Checking if the caller runs the manager loop, the only writer of the snapshot.
+     * @return True if called by the manager task on task mode, always True otherwise
+     */
+bool HaCWifiManager::_isManagerContext()
 {
-    char buffer[128];
-    memset(buffer, '\0', sizeof(buffer));
-    strcpy_P(buffer, (const char*) data);
-    if (this->_onDebugFn)
-        this->_onDebugFn(String(String(HAC_DEBUG_PREFIX) + " " + String(buffer)).c_str());
+     #ifdef HAC_TASK_SUPPORT
+     if (this->_taskMode) return this->_isTaskContext();
+     #endif
+     return true;
+}
+
+/**
+     * Read the status snapshot until a consistent copy is read.
+     * Note: A failed read sleeps a tick, a writer preempted by a higher priority
+     * reader only runs again once the reader blocks.
+     * @param status Status copy
+     */
+void HaCWifiManager::_readStatus(t_wifiStatus &status)
+{
+     while (!this->_status.read(status)) delay(1);
+}
+
+/**
+     * Queue a connect or disconnect request to the manager loop.
+     * Note: Requests are made by one task, the application or the manager loop itself.
+     * @param request Request, its id is assigned here
+     * @return Request handle
+     */
+HaCConnectHandle HaCWifiManager::_queueConnectRequest(t_connectRequest &request)
+{
+     //On task mode the ring is created when the task starts
+     if (!this->_connectRing) this->_connectRing = new HaCSpscRing<t_connectRequest, HAC_CONNECT_QUEUE_SIZE>();
+
+     request.id = this->_connectNextId++;
+     if (this->_connectNextId == 0) this->_connectNextId = 1;
+     if (!this->_connectRing->push(request))
+     {
+          DEBUG_CALLBACK_HAC(F("Connect request queue full."));
+          return HaCConnectHandle(this, 0, CONNECT_QUEUE_FULL);
+     }
+     return HaCConnectHandle(this, request.id);
+}
+
+/**
+     * Start the queued requests and complete a running disconnect.
+     * @param status Station status read on this loop
+     */
+void HaCWifiManager::_runConnectRequests(wl_status_t status)
+{
+     t_connectRequest request;
+     while (this->_connectRing && this->_connectRing->pop(request))
+          this->_startConnectRequest(request);
+
+     //Disconnect is done once the SDK reports the station down
+     if (this->_disconnectRequested && status != WL_CONNECTED)
+          this->_completeConnectRequest(CONNECT_OK);
+}
+
+/**
+     * Start a connect or disconnect request, a running request is cancelled.
+     * @param request Request
+     */
+void HaCWifiManager::_startConnectRequest(const t_connectRequest &request)
+{
+     if (this->_connectOp.id && this->_connectOp.result == CONNECT_PENDING)
+          this->_completeConnectRequest(CONNECT_CANCELLED);
+
+     this->_connectOp = t_connectOperation();
+     this->_connectOp.id = request.id;
+     this->_connectOp.type = request.type;
+     this->_connectOp.startedAt = millis();
+     this->_connectHistory[request.id % HAC_CONNECT_HISTORY].write(this->_connectOp);
+     strcpy(this->_connectSsid, request.ssid);
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG139, (unsigned long)request.id, request.type, request.ssid);
+
+     if (request.type == REQUEST_DISCONNECT)
+     {
+          this->_disconnectRequested = true;
+          this->_stopStation();
+          WiFi.disconnect();
+          return;
+     }
+
+     if(!this->_wifiParam)this->_initParam();
+     if(!this->_wifiParam || this->_wifiParam->getMode() == AP_ONLY)
+     {
+          this->_completeConnectRequest(CONNECT_FAILED);
+          return;
+     }
+
+     //Requested network joins the wifi list, its password may be updated
+     int16_t index = this->_wifiParam->getWifiIndex(request.ssid);
+     if (index < 0 && request.hasPass)
+     {
+          this->_wifiParam->addWifiList(request.ssid, request.pass);
+          index = this->_wifiParam->getWifiIndex(request.ssid);
+     }
+     else if (index >= 0 && request.hasPass && this->_wifiParam->wifiInfo[index].pass != request.pass)
+          this->_wifiParam->wifiInfo[index].pass = request.pass;
+     if (index < 0)
+     {
+          this->_completeConnectRequest(CONNECT_UNKNOWN_SSID);
+          return;
+     }
+     if (this->isQuarantined(request.ssid))
+     {
+          this->_completeConnectRequest(CONNECT_QUARANTINED);
+          return;
+     }
+     if (this->_staState.state() == STA_CONNECTED && this->_connectedSsid == request.ssid)
+     {
+          this->_completeConnectRequest(CONNECT_OK);
+          return;
+     }
+
+     //Connect right away, the backoff or a running attempt are dropped
+     this->_reconnectTimer.stop();
+     this->_attemptFlow.stop();
+     WiFi.disconnect();
+     this->_startCandidate(index);
+}
+
+/**
+     * Complete the running request.
+     * @param result Request result
+     */
+void HaCWifiManager::_completeConnectRequest(ConnectResult result)
+{
+     this->_connectOp.result = result;
+     this->_connectOp.elapsedMs = millis() - this->_connectOp.startedAt;
+     if (result == CONNECT_OK && this->_connectOp.type == REQUEST_CONNECT)
+     {
+          memcpy(this->_connectOp.bssid, this->_connectedBssid, 6);
+          this->_connectOp.channel = this->_connectedChannel;
+     }
+     if (this->_connectOp.type == REQUEST_DISCONNECT) this->_disconnectRequested = false;
+
+     this->_connectHistory[this->_connectOp.id % HAC_CONNECT_HISTORY].write(this->_connectOp);
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG140, (unsigned long)this->_connectOp.id, result, this->_connectOp.elapsedMs);
+}
+
+/**
+     * Complete the running connect request on a failed attempt.
+     * @param result Failure result, CONNECT_FAILED to work it out from the attempt
+     */
+void HaCWifiManager::_failConnectRequest(ConnectResult result)
+{
+     if (!this->_connectOp.id || this->_connectOp.result != CONNECT_PENDING ||
+         this->_connectOp.type != REQUEST_CONNECT) return;
+
+     if (result == CONNECT_FAILED)
+     {
+          if (this->_isAuthFailure()) result = CONNECT_AUTH_FAILED;
+          else if (WiFi.status() == WL_NO_SSID_AVAIL || this->_disconnectReason == DISCONNECT_REASON_NO_AP_FOUND)
+               result = CONNECT_NOT_FOUND;
+          else if (this->_attemptFlow.timedOut()) result = CONNECT_TIMEOUT;
+     }
+     this->_completeConnectRequest(result);
+}
+
+/**
+     * Read the history record of a request.
+     * @param id Request id
+     * @param operation Record, it may belong to another request
+     * @return True if the record belongs to the request else False
+     */
+bool HaCWifiManager::_readConnectOperation(uint32_t id, t_connectOperation &operation)
+{
+     return this->_connectHistory[id % HAC_CONNECT_HISTORY].read(operation) && operation.id == id;
+}
+
+/**
+     * Format an IPv4 address without building a String.
+     * @param ip Address in network order
+     * @param str Output, at least 16 characters
+     */
+void HaCWifiManager::_ipToStr(uint32_t ip, char *str)
+{
+     snprintf(str, 16, "%u.%u.%u.%u", (unsigned int)(ip & 0xFF), (unsigned int)((ip >> 8) & 0xFF),
+              (unsigned int)((ip >> 16) & 0xFF), (unsigned int)(ip >> 24));
+}
+
+#ifdef HAC_TASK_SUPPORT
+/**
+     * Manager task entry.
+     * @param manager Manager instance
+     */
+void HaCWifiManager::_taskEntry(void *manager)
+{
+     HaCWifiManager *self = static_cast<HaCWifiManager *>(manager);
+     self->_taskLoop();
+     self->_taskRunning = false;
+     vTaskDelete(NULL);
+}
+
+/**
+     * Manager task loop, sleeps until the next deadline of the manager.
+     */
+void HaCWifiManager::_taskLoop()
+{
+     while (!this->_taskStop)
+     {
+          this->_loopCore();
+
+          //Wifi status changes are polled, the sleep is capped
+          unsigned long sleepMs = this->nextWakeupMs();
+          if (sleepMs > HAC_TASK_MAX_SLEEP) sleepMs = HAC_TASK_MAX_SLEEP;
+          if (sleepMs == 0) sleepMs = 1;
+          vTaskDelay(pdMS_TO_TICKS(sleepMs) ? pdMS_TO_TICKS(sleepMs) : 1);
+     }
+}
+
+/**
+     * Checking if the caller runs on the manager task.
+     * @return True if called by the manager task else False
+     */
+bool HaCWifiManager::_isTaskContext()
+{
+     return xTaskGetCurrentTaskHandle() == this->_taskHandle;
+}
+#endif
+
+/**
+     * Wifi station onReady event.
+     */
+void HaCWifiManager::_onStationReady()
+{
+     //Connection pipeline done, learn the time to IP of the network
+     if(this->_staState.isConnecting())
+     {
+          t_networkStats *stats = this->_networkStats.get(WiFi.SSID().c_str());
+          stats->timeToIp.addSample(millis() - this->_staAttemptStart);
+          stats->authFailures = 0;
+          stats->quarantineLevel = 0;
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG121, millis() - this->_staAttemptStart,
+               this->_connectDeadline(stats->ssid, false));
+     }
+     //Station uptime starts before the ready event publishes the status
+     this->_connectedSince = millis();
+     this->_statusTimer.begin();
+     this->_setStaState(STA_CONNECTED);
+     this->_raiseEvent(HAC_EVENT_STA_READY, WiFi.SSID().c_str());
+     this->_setupFlow.stop();
+     this->_attemptFlow.stop();
+     this->_reconnectTimer.stop();
+     this->_reconnectBackoff.reset();
+
+     //Initialize MDNS once
+     if(!this->_initMdnsFlagOnce) this->_startMdns();
+
+     //Station downtime caused by a configuration reload
+     if(this->_reloadStaPending)
+     {
+          this->_lastReload.staDowntimeMs = millis() - this->_reloadStaDownAt;
+          this->_reloadStaPending = false;
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG137, this->_lastReload.staDowntimeMs);
+     }
+     //Saving to file and destroying parameters are deferred to a later loop pass
+     this->_savePending = true;
+
+     //Start the background scan which keeps the fallback list warm
+     if(this->_bgScanEnable)
+          this->_bgScanTimer.begin();
+
+     //Reused lease is verified against the gateway, a fresh lease is remembered
+     if(this->_staLeaseApplied)
+     {
+          this->_callStationNetif(NETIF_ARP_REQUEST);
+          this->_leaseVerifyTimer.begin();
+     }
+     else if(this->_leaseReuseEnable && this->_wifiParam &&
+             this->_wifiParam->getWifiEnableDHCP(this->_staCandidateIndex))
+          this->_storeLease(WiFi.SSID().c_str());
+
+     //Remember the access point for the disconnect fast path
+     this->_connectedSsid = WiFi.SSID();
+     this->_connectedChannel = WiFi.channel();
+     memcpy(this->_connectedBssid, WiFi.BSSID(), 6);
+     this->_disconnectReason = 0;
+
+     //Running connect request is done, the station may also have joined another network
+     if (this->_connectOp.id && this->_connectOp.result == CONNECT_PENDING &&
+         this->_connectOp.type == REQUEST_CONNECT)
+          this->_completeConnectRequest(this->_connectedSsid == this->_connectSsid ? CONNECT_OK : CONNECT_FAILED);
+
+     //Start sampling the rssi for roaming
+     this->_roamLowCount = 0;
+     if(this->_roamEnable)
+          this->_roamTimer.begin();
+}
+
+/**
+     * Start MDNS with the device host name.
+     */
+void HaCWifiManager::_startMdns()
+{
+     char hostName[30];
+     memset(hostName, '\0', 30);
+     strcpy(hostName, this->getHostName());
+     //If host name is empty then set the default hostname
+     if(hostName[0] == '\0') strcpy(hostName, DEFAULT_HOST_NAME);
+
+     if(MDNS.begin(hostName))
+     {
+          DEBUG_CALLBACK_HAC(F("MDNS Started."));
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG116, hostName);
+          this->_initMdnsFlagOnce = true;
+     }
+     else
+     {
+          DEBUG_CALLBACK_HAC(F("MDNS failed to start."));
+          this->_printError(23);
+     }              
+}
+
+/**
+     * Wifi station onDisconnect event.
+     * @param recover False if the disconnect is caused by a new connection attempt e.g. roaming
+     */
+void HaCWifiManager::_onStationDisconnected(bool recover)
+{
+     this->_setStaState(STA_IDLE);
+     this->_raiseEvent(HAC_EVENT_STA_DISCONNECT, WiFi.SSID().c_str());
+
+     //Stop the background scan and roaming while the station is down
+     this->_bgScanTimer.stop();
+     this->_roamTimer.stop();
+     this->_roamPending = false;
+     if(this->_bgScanRunning)
+     {
+          WiFi.scanDelete();
+          this->_bgScanRunning = false;
+     }
+
+     //Parameters were destroyed after the station got ready
+     if(!this->_wifiParam) this->_initParam();
+
+     //Reason code delivered by the SDK disconnect event
+     this->_lastDisconnectReason = this->_disconnectReason;
+     this->_disconnectReason = 0;
+
+     //The access point which dropped us is not picked again from the scan cache
+     if (recover) this->_scanCache.remove(this->_connectedBssid);
+
+     //Nothing to recover if the disconnect is caused by a connection attempt e.g. roaming
+     if(recover && this->_wifiParam && this->_wifiParam->getWifiListCount() > 0 &&
+        !this->_recoverFromDisconnect(this->_lastDisconnectReason))
+     {
+          //Set the rssi for the current ssid to the lowest dbM value
+          //in order to put it lowest on the new scanning
+          this->_wifiParam->wifiInfo[0].rssi = -127;
+
+          //if multiwifi is enabled then reinitialized the wifi multimode setup
+          //unless a warm fallback candidate is available from the background scan.
+          //The rescan is delayed by the reconnect backoff so a fleet does not
+          //rescan and reassociate all at once when an access point reboots
+          if (this->_wifiParam->getEnableMultiWifi() && !this->_connectFallbackCandidate())
+          {
+               //The cache may still hold the access points of the network which vanished
+               this->_scanCacheBypass = true;
+               WiFi.disconnect();
+               this->_scheduleReconnect();
+          }
+     }
+}
+
+/**
+     * Wifi onSTALoop event.
+     */
+void HaCWifiManager::_onStationLoop()
+{
+     //TO DO: Pass json data for the status of the STA
+     //Note: On task mode the loop event is raised by the application loop
+     if (this->_onSTALoopFn && !this->_isEventQueued(HAC_EVENT_STA_READY))
+          this->_onSTALoopFn("");
+     
+     //If MDNS initialized, then start MDNS loop
+     #ifdef ESP8266
+     if(this->_initMdnsFlagOnce) MDNS.update();  
+     #endif
+}
+
+/**
+     * Move the station state machine to the next state.
+     * @param next Next station state
+     * @return True if the transition is allowed else False
+     */
+bool HaCWifiManager::_setStaState(StationState next)
+{
+     StationState current = this->_staState.state();
+     if (!this->_staState.transition(next))
+     {
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG135, HaCStationStateMachine::name(current),
+                              HaCStationStateMachine::name(next));
+          return false;
+     }
+
+     if (current != next)
+     {
+          this->_statusDirty = true;
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG134, HaCStationStateMachine::name(current),
+                              HaCStationStateMachine::name(next));
+     }
+     return true;
+}
+
+/**
+     * Debug Callback function.           
+     * @param fn Standard non return function with a const * char parameter.
+     */
+
+void HaCWifiManager::onDebug(tListGenCbFnHaC1StrParamSub fn)
+{
+     this->_onDebugFn = fn;
+}
+
+/**
+     * On Error Callback function.           
+     * @param fn Standard non return function with a const * char parameter.
+     */
+
+void HaCWifiManager::onError(tListGenCbFnHaC1StrParamSub fn)
+{
+     this->_onErrorFn = fn;
+}
+
+/**
+     * On Ready Callback function.           
+     * @param fn Standard non return function with a const * char parameter.
+     */
+
+void HaCWifiManager::onSTAReady(tListGenCbFnHaC1StrParamSub fn)
+{
+     this->_onSTAReadyFn = fn;
+}
+
+/**
+     * On Disconnect Callback function.           
+     * @param fn Standard non return function with a const * char parameter.
+     */
+
+void HaCWifiManager::onSTADisconnect(tListGenCbFnHaC1StrParamSub fn)
+{
+     this->_onSTADisconnectFn = fn;
+}
+
+/**
+     * On Station mode Loop Callback function.           
+     * @param fn Standard non return function with a const * char parameter.
+     */
+
+void HaCWifiManager::onSTALoop(tListGenCbFnHaC1StrParamSub fn)
+{
+     this->_onSTALoopFn = fn;
+}
+
+/**
+     * On AP ready Callback function.           
+     * @param fn Standard non return function with a const * char parameter.
+     */
+
+void HaCWifiManager::onAPReady(tListGenCbFnHaC1StrParamSub fn)
+{
+     this->_onAPReadyFn = fn;
+}
+
+/**
+     * On AP disconnect Callback function.           
+     * @param fn Standard non return function with a const * char parameter.
+     */
+
+void HaCWifiManager::onAPDisconnect(tListGenCbFnHaC1StrParamSub fn)
+{
+     this->_onAPDisconnectFn = fn;
+}
+
+/**
+     * On AP mode Loop Callback function.           
+     * @param fn Standard non return function with a const * char parameter.
+     */
+
+void HaCWifiManager::onAPLoop(tListGenCbFnHaC1StrParamSub fn)
+{
+     this->_onAPLoopFn = fn;
+}
+
+/**
+     * AP new connection Callback function.           
+     * @param fn Standard non return function with a const * char parameter.
+     */
+
+void HaCWifiManager::onAPNewConnection(tListGenCbFnHaC1StrParamSub fn)
+{
+     this->_onAPNewConnectionFn = fn;
+}
+
+/**
+     * On Quarantine Callback function.
+     * Note: The ssid of the quarantined network is passed to the callback.
+     * @param fn Standard non return function with a const * char parameter.
+     */
+
+void HaCWifiManager::onQuarantine(tListGenCbFnHaC1StrParamSub fn)
+{
+     this->_onQuarantineFn = fn;
+}
+
+/**
+ * Debug function.
+ * @param data Debug message .
+ */
+void HaCWifiManager::_debug(const __FlashStringHelper* data)
+{
+    char buffer[128];
+    memset(buffer, '\0', sizeof(buffer));
+    strcpy_P(buffer, (const char*) data);
+    if (this->_onDebugFn)
+        this->_raiseEvent(HAC_EVENT_DEBUG, String(String(HAC_DEBUG_PREFIX) + " " + String(buffer)).c_str());
+}
+
+/**
+     * Debug function.     
+     * @param data const char .
+     */
+
+void HaCWifiManager::_debug(const char *data)
+{
+     if (this->_onDebugFn)
+          this->_raiseEvent(HAC_EVENT_DEBUG, String(String(HAC_DEBUG_PREFIX) + " " + String(data)).c_str());
+}
+
+
+
+/**
+     * Print error function.     
+     * @param data uint8_t .
+     */
+
+void HaCWifiManager::_printError(uint8_t errorCode)
+{
+     if (this->_onErrorFn)
+          this->_raiseEvent(HAC_EVENT_ERROR, String(errorCode).c_str());
+}
+
+/**
+     * Raise an event to the application.
+     * Note: On task mode, events raised by the manager task are queued and delivered
+     * by the application loop. On deferred dispatch the station and access point
+     * events are queued and delivered once the manager step is done.
+     * @param type Event type
+     * @param data Event data
+     */
+void HaCWifiManager::_raiseEvent(HaCEventType type, const char *data)
+{
+     //Callbacks see the status the event is about, only the manager writes it
+     if (this->_statusDirty && this->_isManagerContext()) this->_publishStatus();
+     if (this->_eventRing && this->_isEventQueued(type))
+     {
+          t_hacEvent event;
+          event.type = type;
+          event.timestamp = millis();
+          strncpy(event.data, data, HAC_EVENT_DATA_SIZE - 1);
+          event.data[HAC_EVENT_DATA_SIZE - 1] = '\0';
+          //Debug events leave room for the state events
+          bool full = type == HAC_EVENT_DEBUG && this->_eventRing->size() >= HAC_EVENT_QUEUE_SIZE - HAC_EVENT_STATE_RESERVE;
+          if (full || !this->_eventRing->push(event))
+          {
+               this->_eventsDropped.fetch_add(1, std::memory_order_relaxed);
+               return;
+          }
+          this->_eventsQueued.fetch_add(1, std::memory_order_relaxed);
+          unsigned long depth = this->_eventRing->size();
+          if (depth > this->_eventsMaxDepth.load(std::memory_order_relaxed))
+               this->_eventsMaxDepth.store(depth, std::memory_order_relaxed);
+          return;
+     }
+     this->_callEvent(type, data);
+}
+
+/**
+     * Call the application callback of an event.
+     * @param type Event type
+     * @param data Event data
+     */
+void HaCWifiManager::_callEvent(HaCEventType type, const char *data)
+{
+     tListGenCbFnHaC1StrParam *fn = nullptr;
+     switch (type)
+     {
+     case HAC_EVENT_DEBUG: fn = &this->_onDebugFn; break;
+     case HAC_EVENT_ERROR: fn = &this->_onErrorFn; break;
+     case HAC_EVENT_STA_READY: fn = &this->_onSTAReadyFn; break;
+     case HAC_EVENT_STA_DISCONNECT: fn = &this->_onSTADisconnectFn; break;
+     case HAC_EVENT_AP_READY: fn = &this->_onAPReadyFn; break;
+     case HAC_EVENT_AP_DISCONNECT: fn = &this->_onAPDisconnectFn; break;
+     case HAC_EVENT_AP_NEW_CONNECTION: fn = &this->_onAPNewConnectionFn; break;
+     case HAC_EVENT_QUARANTINE: fn = &this->_onQuarantineFn; break;
+     default: break;
+     }
+     if (fn && *fn) (*fn)(data);
+}
+
+/**
+     * Registering the wifi events delivered by the SDK.
+     */
+void HaCWifiManager::_registerWifiEvents()
+{
+     if(this->_wifiEventsRegistered) return;
+
+     #ifdef ESP32
+     WiFi.onEvent([&](WiFiEvent_t event, WiFiEventInfo_t info)
+                  {
+                       this->_scanDoneFlag = true;
+                  }, __WIFI_EVENT_SCAN_DONE__);
+     WiFi.onEvent([&](WiFiEvent_t event, WiFiEventInfo_t info)
+                  {
+                       this->_staAssociated = true;
+                  }, __WIFI_EVENT_STA_CONNECTED__);
+     WiFi.onEvent([&](WiFiEvent_t event, WiFiEventInfo_t info)
+                  {
+                       this->_staAssociated = false;
+                       this->_disconnectReason = __WIFI_EVENT_DISCONNECT_REASON__(info);
+                  }, __WIFI_EVENT_STA_DISCONNECTED__);
+     #else
+     this->_staConnectedHandler = WiFi.onStationModeConnected([&](const WiFiEventStationModeConnected &event)
+                                                              {
+                                                                   this->_staAssociated = true;
+                                                              });
+     this->_staDisconnectedHandler = WiFi.onStationModeDisconnected([&](const WiFiEventStationModeDisconnected &event)
+                                                                    {
+                                                                         this->_staAssociated = false;
+                                                                         this->_disconnectReason = event.reason;
+                                                                    });
+     #endif
+
+     this->_wifiEventsRegistered = true;
+}
+
+/**
+     * Setting up wifi configuration based on the mode   
+     */
+void HaCWifiManager::_initWifiManager()
+{
+     if(!this->_wifiParam)return;
+
+     switch (this->_wifiParam->getMode())
+     {
+     case STA_ONLY:
+          WiFi.softAPdisconnect(true);
+          WiFi.mode(WIFI_STA);
+          this->_initStation();
+          break;
+     case AP_ONLY:
+          WiFi.softAPdisconnect(true);
+          WiFi.disconnect();
+          WiFi.mode(WIFI_OFF);
+          #ifdef ESP8266
+          WiFi.forceSleepBegin();
+          #endif
+          this->_startAccessPoint();
+          break;
+     case BOTH_STA_AP:
+          WiFi.mode(WIFI_AP_STA);
+          this->_initStation();
+          //Access point is brought up from the loop once the radio settled
+          this->_apStartupTimer.onTick([&]()
+                                       {
+                                            this->_startAccessPoint();
+                                       });
+          this->_apStartupTimer.beginOnce();
+          break;
+     default:
+          break;
+     }
+}
+
+/**
+     * Setting up wifi configuration based on the mode   
+     */
+void HaCWifiManager::_initStation()
+{
+     if(!this->_wifiParam)this->_initParam();
+     if(!this->_wifiParam) return;
+
+     DEBUG_CALLBACK_HAC(F("Initializing station.."));
+     //A running session is closed first, the transition table has no way from connected to scanning
+     this->_stopStation();
+
+     //Check if it is multi or single wifi
+     if (this->_wifiParam->getEnableMultiWifi())
+          this->_setupSTAMultiWifi();
+     else
+          this->_setupSTASingleWifi();
+}
+
+/**
+     * Setting multi wifi mode.     
+     */
+void HaCWifiManager::_setupSTAMultiWifi()
+{
+     //If there is only one ssid on the list then set it up as a single wifi
+     if (this->_wifiParam->getWifiListCount() == 1)
+     {
+          this->_setupSTASingleWifi();
+          return;
+     }
+     DEBUG_CALLBACK_HAC(F("Setting up STA multi wifi.."));
+
+     //Reuse the recent scan instead of scanning again, unless a rescan was asked for
+     bool bypass = this->_scanCacheBypass;
+     this->_scanCacheBypass = false;
+     if (!bypass && this->_rankWifiFromScanCache())
+     {
+          DEBUG_CALLBACK_HAC(F("Using the scan cache."));
+          WiFi.disconnect();
+          this->_setupSTASingleWifi();
+          return;
+     }
+
+     //Clean previous scan
+     WiFi.scanDelete();
+     DEBUG_CALLBACK_HAC(F("Deleted previous scan."));
+     //Remove previous wifi ssid&password
+     WiFi.disconnect();
+     DEBUG_CALLBACK_HAC(F("Previous wifi session ssid/password."));
+     //Start wifi scan, completion is awaited by the setup flow
+     this->_wifiScanCountAttempt = 0;
+     this->_setStaState(STA_SCANNING);
+     this->_startScanAsync();
+     DEBUG_CALLBACK_HAC(F("Start wifi scan in async mode"));
+     this->_setupFlow.restart();
+}
+
+/**
+     * Start an asynchronous wifi scan.
+     * Note: The scan done event sets the scan done flag which is handled on the next loop.
+     * @return True if the scan started else False
+     */
+bool HaCWifiManager::_startScanAsync()
+{
+     this->_scanDoneFlag = false;
+     #ifdef ESP8266
+     WiFi.scanNetworksAsync([&](int count)
+                            {
+                                 this->_scanDoneFlag = true;
+                            });
+     return true;
+     #endif
+     #ifdef ESP32
+     return WiFi.scanNetworks(true) != WIFI_SCAN_FAILED;
+     #endif
+}
+
+/**
+     * Rank the wifi list once the multi wifi scan result has been collected.
+     */
+void HaCWifiManager::_handleWifiScan()
+{
+     if (!this->_scanListFound)
+     {
+          DEBUG_CALLBACK_HAC(F("Warning: None of ssid listed was found from the scanning."));
+          this->_printError(12);
+     }
+     else
+          this->_sortWifiRssi();
+
+     DEBUG_CALLBACK_HAC(F("Multiwifi setup done."));
+}
+
+/**
+     * Station setup flow, resumed on every loop.
+     * Note: Awaits the multi wifi scan if one is running, lets the radio settle
+     * and starts the first ranked candidate.
+     */
+void HaCWifiManager::_runSetupFlow()
+{
+     HAC_FLOW_BEGIN(this->_setupFlow);
+
+     //Scan completion is delivered by the scan done event, the timeout is only a safety net
+     while (this->_staState.state() == STA_SCANNING)
+     {
+          HAC_FLOW_WAIT_UNTIL(this->_setupFlow, this->_scanDoneFlag, WIFI_SCAN_TIMEOUT);
+          this->_scanDoneFlag = false;
+          if (WiFi.scanComplete() > 0) break;
+          if (!this->_setupFlow.timedOut()) continue;
+
+          //Raise error if wifi scan fail for max attempt
+          if (++this->_wifiScanCountAttempt > MAX_WIFI_SCAN_ATTEMPT)
+          {
+               this->_wifiScanFail = true;
+               this->_printError(11);
+               DEBUG_CALLBACK_HAC(F("Wifi scan failed or timeout."));
+               this->_setupFlow.stop();
+               this->_scheduleReconnect();
+               return;
+          }
+     }
+
+     //Scan result is collected in slices within the loop budget
+     if (this->_staState.state() == STA_SCANNING)
+     {
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG104, WiFi.scanComplete());
+          DEBUG_CALLBACK_HAC(F("Scanning Wifi AP Rssi.."));
+          this->_scanIndex = 0;
+          this->_scanListFound = false;
+          while (this->_scanIndex < WiFi.scanComplete())
+          {
+               //The next result is expected to cost as much as the last one
+               this->_scanItemUs = micros();
+               if (this->_scanWifiListRssi(this->_scanIndex++)) this->_scanListFound = true;
+               this->_scanItemUs = micros() - this->_scanItemUs;
+               if (this->_scanIndex < WiFi.scanComplete() && !this->_hasBudget(this->_scanItemUs))
+               {
+                    this->_loopStats.deferred++;
+                    HAC_FLOW_YIELD(this->_setupFlow);
+               }
+          }
+          this->_handleWifiScan();
+     }
+
+     //Radio settles before the first attempt, on startup as well as on reconnection
+     this->_setStaState(STA_STARTING);
+     HAC_FLOW_DELAY(this->_setupFlow, STARTUP_SETTLE_DELAY);
+     this->_startCandidate(0);
+
+     HAC_FLOW_END(this->_setupFlow);
+}
+
+/**
+     * Collect the rssi of a scanned access point.
+     * @param index Index of the access point on the scan result
+     * @return True if the access point is on the wifi list else False
+     */
+bool HaCWifiManager::_scanWifiListRssi(uint8_t index)
+{
+     if(!this->_wifiParam)return false;
+
+     String ssid;
+     int32_t rssi;
+     uint8_t encType;
+     uint8_t *bssid;
+     int32_t channel;
+     #ifdef ESP8266
+     bool hidden;
+     #endif
+     bool atleastOneSsidListFoundFlag = false;
+
+     // Get network information
+     #ifdef ESP8266
+     WiFi.getNetworkInfo(index, ssid, encType, rssi, bssid, channel, hidden);
+     #endif
+     #ifdef ESP32
+     WiFi.getNetworkInfo(index, ssid, encType, rssi, bssid, channel);
+     #endif
+
+     this->_scanCache.update(ssid.c_str(), bssid, rssi, channel);
+
+     // Check if the WiFi network contains an entry in Wifiinfo list
+     uint8_t j = 0;
+     for (auto &entry : this->_wifiParam->wifiInfo)
+     {
+          // Check SSID
+          if (ssid == entry.ssid)
+          {
+               // Known network
+               atleastOneSsidListFoundFlag = true;
+               this->_wifiParam->wifiInfo[j].rssi = rssi;
+               DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG105, ssid.c_str());
+               DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG106, this->_wifiParam->wifiInfo[j].rssi);
+          }
+          j++;
+     }
+
+     return atleastOneSsidListFoundFlag;
+}
+
+/**
+     * Sort wifi list from strongest to weakest rssi.     
+     * @param totalAP- Total number of access point scanned
+     */
+void HaCWifiManager::_sortWifiRssi()
+{
+     if(!this->_wifiParam)return;
+
+     DEBUG_CALLBACK_HAC(F("Sorting Wifi AP based on Rssi"));
+
+     //Quarantined networks are ranked last and skipped as candidates
+     for (auto &entry : this->_wifiParam->wifiInfo)
+          if (this->isQuarantined(entry.ssid.c_str()))
+               entry.rssi = -127;
+
+     for (uint8_t i = 0; i < this->_wifiParam->getWifiListCount(); i++)
+     {
+          for (uint8_t j = 0; j < this->_wifiParam->getWifiListCount(); j++)
+          {
+               if (this->_wifiParam->wifiInfo[i].rssi > this->_wifiParam->wifiInfo[j].rssi)
+               {
+                    t_wifiInfo tmp;
+
+               tmp = this->_wifiParam->wifiInfo[i];
+                    this->_wifiParam->wifiInfo[i] = this->_wifiParam->wifiInfo[j];
+                    this->_wifiParam->wifiInfo[j] = tmp;
+               }
+          }
+     }
+
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG107, this->_wifiParam->wifiInfo[0].ssid.c_str());
+}
+
+/**
+     * Start a low duty background scan while the station is connected.
+     */
+void HaCWifiManager::_startBackgroundScan()
+{
+     //Safety net in case the scan done event of the previous scan is missed
+     if(this->_bgScanRunning)
+     {
+          this->_handleBackgroundScan();
+          return;
+     }
+     if(!this->_bgScanEnable || this->_throughputSensitive) return;
+     if(!this->_wifiParam || !this->_wifiParam->getEnableMultiWifi()) return;
+     if(WiFi.status() != WL_CONNECTED) return;
+
+     WiFi.scanDelete();
+     if(!this->_startScanAsync())
+     {
+          DEBUG_CALLBACK_HAC(F("Background scan failed to start."));
+          return;
+     }
+     this->_bgScanRunning = true;
+     DEBUG_CALLBACK_HAC(F("Background scan started."));
+}
+
+/**
+     * Collect the background scan result into the ranked fallback list.
+     * Note: The access point currently in use is excluded from the list.
+     */
+void HaCWifiManager::_handleBackgroundScan()
+{
+     int8_t count = WiFi.scanComplete();
+     if(count == WIFI_SCAN_RUNNING) return;
+
+     this->_bgScanRunning = false;
+     if(count < 0 || !this->_wifiParam)
+     {
+          DEBUG_CALLBACK_HAC(F("Background scan failed."));
+          WiFi.scanDelete();
+          return;
+     }
+
+     String ssid;
+     int32_t rssi;
+     uint8_t encType;
+     uint8_t *bssid;
+     int32_t channel;
+     #ifdef ESP8266
+     bool hidden;
+     #endif
+     uint8_t currentBssid[6];
+     memcpy(currentBssid, WiFi.BSSID(), 6);
+
+     this->_fallbackList.clear();
+     for (uint8_t i = 0; i < count; i++)
+     {
+          #ifdef ESP8266
+          WiFi.getNetworkInfo(i, ssid, encType, rssi, bssid, channel, hidden);
+          #endif
+          #ifdef ESP32
+          WiFi.getNetworkInfo(i, ssid, encType, rssi, bssid, channel);
+          #endif
+
+          this->_scanCache.update(ssid.c_str(), bssid, rssi, channel);
+          if (memcmp(bssid, currentBssid, 6) == 0) continue;
+
+          bool known = false;
+          for (auto &entry : this->_wifiParam->wifiInfo)
+               if (ssid == entry.ssid) known = true;
+          if (!known) continue;
+
+          t_wifiCandidate candidate;
+          candidate.ssid = ssid;
+          memcpy(candidate.bssid, bssid, 6);
+          candidate.channel = channel;
+          candidate.rssi = rssi;
+
+          //Insert the candidate from strongest to weakest rssi
+          auto it = this->_fallbackList.begin();
+          while (it != this->_fallbackList.end() && it->rssi >= candidate.rssi) it++;
+          this->_fallbackList.insert(it, candidate);
+          if (this->_fallbackList.size() > MAX_FALLBACK_LIST)
+               this->_fallbackList.pop_back();
+     }
+     WiFi.scanDelete();
+     this->_fallbackListTimestamp = millis();
+
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG117, this->_fallbackList.size());
+
+     //Scan was requested by roaming
+     if(this->_roamPending)
+     {
+          this->_roamPending = false;
+          this->_roamToBetterCandidate(WiFi.RSSI());
+     }
+}
+
+/**
+     * Getting the recovery action of a disconnect reason.
+     * @param reason SDK disconnect reason code
+     * @return Recovery action
+     */
+DisconnectAction HaCWifiManager::_disconnectAction(uint8_t reason)
+{
+     static const t_disconnectRecovery recoveryTable[] = {
+         {DISCONNECT_REASON_AUTH_EXPIRE, RECOVER_SAME_BSSID},
+         {DISCONNECT_REASON_ASSOC_EXPIRE, RECOVER_SAME_BSSID},
+         {DISCONNECT_REASON_BEACON_TIMEOUT, RECOVER_SAME_BSSID},
+         {DISCONNECT_REASON_4WAY_HANDSHAKE_TIMEOUT, RECOVER_NEXT_CANDIDATE},
+         {DISCONNECT_REASON_AUTH_FAIL, RECOVER_NEXT_CANDIDATE},
+         {DISCONNECT_REASON_ASSOC_FAIL, RECOVER_NEXT_CANDIDATE},
+         {DISCONNECT_REASON_HANDSHAKE_TIMEOUT, RECOVER_NEXT_CANDIDATE},
+         {DISCONNECT_REASON_NO_AP_FOUND, RECOVER_RESCAN},
+     };
+
+     for (auto &entry : recoveryTable)
+          if (entry.reason == reason) return entry.action;
+
+     return RECOVER_RESCAN;
+}
+
+/**
+     * Apply the fast recovery path of a station disconnect.
+     * Note: Rescan is left to the default disconnect handling.
+     * @param reason SDK disconnect reason code
+     * @return True if the disconnect has been handled else False
+     */
+bool HaCWifiManager::_recoverFromDisconnect(uint8_t reason)
+{
+     DisconnectAction action = this->_disconnectAction(reason);
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG126, reason, action);
+
+     //Locate the access point which dropped us on the wifi list
+     int16_t index = -1;
+     for (uint8_t i = 0; i < this->_wifiParam->getWifiListCount(); i++)
+     {
+          if (this->_wifiParam->wifiInfo[i].ssid != this->_connectedSsid) continue;
+          index = i;
+          break;
+     }
+     if (index < 0) return false;
+     this->_staCandidateIndex = index;
+
+     switch (action)
+     {
+     case RECOVER_SAME_BSSID:
+          //The retry goes through the backoff, a rebooting access point drops the whole fleet
+          //at once. The watchdog moves on to the next candidate if the access point is really gone
+          this->_scheduleReconnect(true);
+          return true;
+     case RECOVER_NEXT_CANDIDATE:
+          if (!this->_wifiParam->getEnableMultiWifi()) return false;
+          this->_wifiParam->wifiInfo[index].rssi = -127;
+          this->_connectNextCandidate();
+          return true;
+     default:
+          return false;
+     }
+}
+
+/**
+     * Sample the rssi of the connected access point and roam when it stays weak.
+     * Note: Roaming happens only after the minimum dwell time on the current access point
+     * and only to a known access point stronger by at least the hysteresis margin.
+     */
+void HaCWifiManager::_handleRoaming()
+{
+     if (this->_staState.state() != STA_CONNECTED || this->_bgScanRunning) return;
+
+     int8_t rssi = WiFi.RSSI();
+     if (rssi >= this->_roamRssiThreshold)
+     {
+          this->_roamLowCount = 0;
+          return;
+     }
+
+     if (this->_roamLowCount < ROAM_LOW_SAMPLES) this->_roamLowCount++;
+     if (this->_roamLowCount < ROAM_LOW_SAMPLES) return;
+     if (millis() - this->_connectedSince < this->_roamDwellMs) return;
+
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG124, rssi);
+     if (this->_roamToBetterCandidate(rssi)) return;
+
+     //No candidate on the scan cache, refresh it
+     if (millis() - this->_lastRoamScan < ROAM_SCAN_INTERVAL && this->_lastRoamScan != 0) return;
+     this->_lastRoamScan = millis();
+
+     WiFi.scanDelete();
+     if (!this->_startScanAsync())
+     {
+          DEBUG_CALLBACK_HAC(F("Roaming scan failed to start."));
+          return;
+     }
+     this->_bgScanRunning = true;
+     this->_roamPending = true;
+}
+
+/**
+     * Roam to the strongest known access point of the scan cache.
+     * @param currentRssi Rssi of the connected access point
+     * @return True if roaming started else False
+     */
+bool HaCWifiManager::_roamToBetterCandidate(int8_t currentRssi)
+{
+     if (!this->_wifiParam) return false;
+
+     uint8_t currentBssid[6];
+     memcpy(currentBssid, WiFi.BSSID(), 6);
+
+     t_scanCacheEntry target;
+     int16_t targetIndex = -1;
+     for (auto &entry : this->_scanCache)
+     {
+          if (memcmp(entry.bssid, currentBssid, 6) == 0) continue;
+          if (entry.rssi < currentRssi + this->_roamHysteresisDb) continue;
+          if (targetIndex >= 0 && entry.rssi <= target.rssi) continue;
+
+          //Roaming never trades a working link for a quarantined network
+          if (this->isQuarantined(entry.ssid)) continue;
+
+          for (uint8_t i = 0; i < this->_wifiParam->getWifiListCount(); i++)
+          {
+               if (this->_wifiParam->wifiInfo[i].ssid != entry.ssid) continue;
+               target = entry;
+               targetIndex = i;
+               break;
+          }
+     }
+     if (targetIndex < 0) return false;
+
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG125, target.ssid, currentRssi, target.rssi);
+     this->_roamLowCount = 0;
+     this->_staCandidateIndex = targetIndex;
+     this->_startStation(this->_wifiParam->wifiInfo[targetIndex].ssid.c_str(),
+                         this->_wifiParam->wifiInfo[targetIndex].pass.c_str(),
+                         target.channel, target.bssid);
+     return true;
+}
+
+/**
+     * Connect to the strongest candidate of the fallback list without scanning.
+     * @return True if a fallback candidate was started else False
+     */
+bool HaCWifiManager::_connectFallbackCandidate()
+{
+     if(!this->_bgScanEnable || this->_fallbackList.empty() || !this->_wifiParam) return false;
+
+     if(millis() - this->_fallbackListTimestamp > FALLBACK_LIST_MAX_AGE)
+     {
+          DEBUG_CALLBACK_HAC(F("Fallback list expired."));
+          this->_fallbackList.clear();
+          return false;
+     }
+
+     //Rank the wifi list from the fallback candidates
+     for (auto &entry : this->_wifiParam->wifiInfo)
+     {
+          entry.rssi = -127;
+          for (auto &candidate : this->_fallbackList)
+               if (candidate.ssid == entry.ssid && candidate.rssi > entry.rssi)
+                    entry.rssi = candidate.rssi;
+     }
+     this->_sortWifiRssi();
+
+     //Quarantined networks are ranked last, only those are left if the first one is quarantined
+     if (this->isQuarantined(this->_wifiParam->wifiInfo[0].ssid.c_str()))
+     {
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG128, this->_wifiParam->wifiInfo[0].ssid.c_str());
+          return false;
+     }
+
+     //Fallback list is sorted hence the first match is the strongest access point
+     for (auto it = this->_fallbackList.begin(); it != this->_fallbackList.end(); it++)
+     {
+          if (it->ssid != this->_wifiParam->wifiInfo[0].ssid) continue;
+
+          t_wifiCandidate candidate = *it;
+          this->_fallbackList.erase(it);
+
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG118, candidate.ssid.c_str(), candidate.rssi);
+          this->_staCandidateIndex = 0;
+          this->_startStation(this->_wifiParam->wifiInfo[0].ssid.c_str(),
+                              this->_wifiParam->wifiInfo[0].pass.c_str(),
+                              candidate.channel, candidate.bssid);
+          return true;
+     }
+
+     return false;
+}
+
+/**
+     * Rank the wifi list from the scan cache.
+     * @return True if at least one ssid listed is on the scan cache else False
+     */
+bool HaCWifiManager::_rankWifiFromScanCache()
+{
+     if(!this->_wifiParam)return false;
+
+     bool atleastOneSsidListFoundFlag = false;
+     for (auto &entry : this->_wifiParam->wifiInfo)
+     {
+          const t_scanCacheEntry *cached = this->_scanCache.best(entry.ssid.c_str());
+          entry.rssi = cached ? cached->rssi : -127;
+          if (cached) atleastOneSsidListFoundFlag = true;
+     }
+
+     if (atleastOneSsidListFoundFlag)
+          this->_sortWifiRssi();
+
+     return atleastOneSsidListFoundFlag;
+}
+
+/**
+     * Setting single wifi mode.     
+     */
+void HaCWifiManager::_setupSTASingleWifi()
+{
+     if(!this->_wifiParam)this->_initParam();
+     if(!this->_wifiParam)return;
+
+     DEBUG_CALLBACK_HAC(F("Setting up single STA wifi.."));
+     //Wifi setup is done asynchronously by the setup flow
+     this->_setStaState(STA_STARTING);
+     this->_setupFlow.restart();
+}
+
+/**
+     * Start the connection attempt of a ranked candidate from the wifi list.
+     * @param index Index of the candidate from the wifi list
+     */
+void HaCWifiManager::_startCandidate(uint8_t index)
+{
+     if(!this->_wifiParam || index >= this->_wifiParam->getWifiListCount())return;
+
+     this->_staCandidateIndex = index;
+     t_wifiInfo &candidate = this->_wifiParam->wifiInfo[index];
+
+     //Lock on the strongest cached access point of the ssid if available
+     const t_scanCacheEntry *cached = this->_scanCache.best(candidate.ssid.c_str());
+     this->_startStation(candidate.ssid.c_str(),
+                         candidate.pass.c_str(),
+                         cached ? cached->channel : 0,
+                         cached ? cached->bssid : nullptr);
+}
+
+/**
+     * Move the connection pipeline to the next ranked candidate.
+     * Note: On multi wifi, candidates not found on the last scan are skipped.
+     * If all candidates failed then the station is reinitialized.
+     */
+void HaCWifiManager::_connectNextCandidate()
+{
+     //The requested network failed, the pipeline moves on with the wifi list
+     this->_failConnectRequest();
+     this->_attemptFlow.stop();
+     if(!this->_wifiParam)this->_initParam();
+     if(!this->_wifiParam)return;
+
+     uint8_t index = this->_nextCandidateIndex();
+     if (index >= this->_wifiParam->getWifiListCount())
+     {
+          DEBUG_CALLBACK_HAC(F("All connection candidates failed."));
+          this->_scheduleReconnect();
+          return;
+     }
+
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG119, this->_wifiParam->wifiInfo[index].ssid.c_str());
+     WiFi.disconnect();
+     this->_startCandidate(index);
+}
+
+/**
+     * Checking if the current connection attempt failed on authentication.
+     * @return True if the credential is likely wrong else False
+     */
+bool HaCWifiManager::_isAuthFailure()
+{
+     #ifdef ESP8266
+     if (WiFi.status() == WL_WRONG_PASSWORD) return true;
+     #endif
+
+     uint8_t reason = this->_disconnectReason;
+     return reason == DISCONNECT_REASON_AUTH_FAIL ||
+            reason == DISCONNECT_REASON_4WAY_HANDSHAKE_TIMEOUT ||
+            reason == DISCONNECT_REASON_HANDSHAKE_TIMEOUT;
+}
+
+/**
+     * Record the failure of the current connection attempt.
+     * Note: Repeated authentication failures move the network to quarantine.
+     */
+void HaCWifiManager::_recordConnectFailure()
+{
+     if (!this->_wifiParam || this->_staCandidateIndex >= this->_wifiParam->getWifiListCount()) return;
+     if (!this->_isAuthFailure()) return;
+
+     t_networkStats *stats = this->_networkStats.get(this->_wifiParam->wifiInfo[this->_staCandidateIndex].ssid.c_str());
+     if (++stats->authFailures >= QUARANTINE_AUTH_FAILURES)
+          this->_quarantine(stats);
+}
+
+/**
+     * Quarantine a network, the period doubles on every quarantine up to the cap.
+     * @param stats Statistics of the network
+     */
+void HaCWifiManager::_quarantine(t_networkStats *stats)
+{
+     unsigned long period = QUARANTINE_CAP;
+     if (stats->quarantineLevel < 16 && ((unsigned long)QUARANTINE_BASE << stats->quarantineLevel) < QUARANTINE_CAP)
+          period = (unsigned long)QUARANTINE_BASE << stats->quarantineLevel;
+
+     stats->quarantined = true;
+     stats->quarantineUntil = millis() + period;
+     stats->authFailures = 0;
+     if (stats->quarantineLevel < 255) stats->quarantineLevel++;
+
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG127, stats->ssid, period);
+     this->_printError(24);
+     this->_raiseEvent(HAC_EVENT_QUARANTINE, stats->ssid);
+}
+
+/**
+     * Seed the reconnect backoff jitter from the device mac address.
+     */
+void HaCWifiManager::_seedReconnectBackoff()
+{
+     uint8_t mac[6] = {0};
+     #ifdef ESP8266
+     WiFi.macAddress(mac);
+     #endif
+     #ifdef ESP32
+     //Station mac is not available before the wifi driver starts
+     uint64_t efuseMac = ESP.getEfuseMac();
+     memcpy(mac, &efuseMac, 6);
+     #endif
+     this->_reconnectBackoff.seed(mac);
 }
 
 /**
-     * Debug function.     
-     * @param data const char .
+     * Schedule the reinitialization of the station after the reconnect backoff delay.
+     * Note: A first retry to the same access point only waits a short jitter, later
+     * retries follow the backoff.
+     * @param sameBssid True to reconnect to the access point of the candidate index
      */
-
-void HaCWifiManager::_debug(const char *data)
+void HaCWifiManager::_scheduleReconnect(bool sameBssid)
 {
-     if (this->_onDebugFn)
-          this->_onDebugFn(String(String(HAC_DEBUG_PREFIX) + " " + String(data)).c_str());
+     unsigned long delayMs = sameBssid && this->_reconnectBackoff.attempts() == 0 ?
+                             this->_reconnectBackoff.jitter() : this->_reconnectBackoff.next();
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG123, delayMs, this->_reconnectBackoff.attempts());
+
+     this->_setStaState(STA_BACKOFF);
+     this->_reconnectTimer = Tick(delayMs, this->_timers);
+     this->_reconnectTimer.onTick([this, sameBssid]()
+                                  {
+                                       if (this->_staState.state() != STA_BACKOFF) return;
+                                       uint8_t index = this->_staCandidateIndex;
+                                       if (!sameBssid || !this->_wifiParam || index >= this->_wifiParam->getWifiListCount())
+                                       {
+                                            this->_initStation();
+                                            return;
+                                       }
+                                       this->_startStation(this->_wifiParam->wifiInfo[index].ssid.c_str(),
+                                                           this->_wifiParam->wifiInfo[index].pass.c_str(),
+                                                           this->_connectedChannel, this->_connectedBssid);
+                                  });
+     this->_reconnectTimer.beginOnce();
 }
 
+/**
+     * Getting the index of the next ranked candidate.
+     * @return Index of the next candidate, wifi list count if there is none
+     */
+uint8_t HaCWifiManager::_nextCandidateIndex()
+{
+     if(!this->_wifiParam)return 0;
+
+     uint8_t index = this->_staCandidateIndex + 1;
+     if (!this->_wifiParam->getEnableMultiWifi())
+          return this->_wifiParam->getWifiListCount();
 
+     while (index < this->_wifiParam->getWifiListCount() &&
+            this->_wifiParam->wifiInfo[index].rssi == -127)
+          index++;
+
+     return index;
+}
 
 /**
-     * Print error function.     
-     * @param data uint8_t .
+     * Getting the watchdog deadline of a connection attempt.
+     * Note: Networks without enough history use the attempt timeout, except the last
+     * candidate which is given the ceiling as there is nothing else to try.
+     * @param ssid Network ssid
+     * @param lastCandidate True if there is no other candidate after this attempt
+     * @return Watchdog deadline in millisecond
      */
-
-void HaCWifiManager::_printError(uint8_t errorCode)
+unsigned long HaCWifiManager::_connectDeadline(const char *ssid, bool lastCandidate)
 {
-     if (this->_onErrorFn)
-          this->_onErrorFn(String(errorCode).c_str());
+     t_networkStats *stats = this->_networkStats.get(ssid, false);
+     if (stats && stats->timeToIp.count() >= CONNECT_ESTIMATOR_MIN_SAMPLES)
+          return stats->timeToIp.deadline(this->_watchdogK, this->_watchdogFloorMs, this->_watchdogCeilingMs);
+
+     if (lastCandidate) return this->_watchdogCeilingMs;
+     return constrain(this->_connectAttemptTimeoutMs, this->_watchdogFloorMs, this->_watchdogCeilingMs);
 }
 
 /**
-     * Setting up wifi configuration based on the mode   
+     * Connection attempt flow, resumed on every loop.
+     * Note: Association and IP acquisition are awaited as separate phases, each step
+     * runs on the loop its event is seen. A stalled DHCP is restarted before moving
+     * to the next candidate.
+     * @param status Station status read on this loop
      */
-void HaCWifiManager::_initWifiManager()
+void HaCWifiManager::_runAttemptFlow(wl_status_t status)
 {
-     if(!this->_wifiParam)return;
+     HAC_FLOW_BEGIN(this->_attemptFlow);
 
-     switch (this->_wifiParam->getMode())
+     HAC_FLOW_WAIT_UNTIL(this->_attemptFlow, this->_staAssociated || this->_isAttemptFailed(status),
+                         this->_staAttemptDeadlineMs);
+     if (!this->_staAssociated)
      {
-     case STA_ONLY:
-          WiFi.softAPdisconnect(true);
-          WiFi.mode(WIFI_STA);
-          this->_initStation();
-          break;
-     case AP_ONLY:
-          WiFi.softAPdisconnect(true);
-          WiFi.disconnect();
-          WiFi.mode(WIFI_OFF);
-          #ifdef ESP8266
-          WiFi.forceSleepBegin();
-          #endif
-          this->_startAccessPoint();
-          break;
-     case BOTH_STA_AP:
-          WiFi.mode(WIFI_AP_STA);
-          this->_initStation();
-          delay(1000);
-          this->_startAccessPoint();
-          break;
-     default:
-          break;
+          if (this->_attemptFlow.timedOut())
+          {
+               DEBUG_CALLBACK_HAC(F("Connection attempt timeout."));
+          }
+          else
+          {
+               DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG120, status);
+          }
+          this->_recordConnectFailure();
+          this->_connectNextCandidate();
+          return;
+     }
+
+     this->_setStaState(STA_DHCP);
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG129, millis() - this->_staAttemptStart);
+     while (true)
+     {
+          //Static network has no DHCP to wait for, the association deadline keeps running
+          HAC_FLOW_WAIT_UNTIL(this->_attemptFlow, !this->_staAssociated, this->_dhcpWaitMs());
+          if (!this->_staAssociated)
+          {
+               DEBUG_CALLBACK_HAC(F("Association lost while waiting for IP."));
+               this->_connectNextCandidate();
+               return;
+          }
+          if (!this->_isDhcpAttempt())
+          {
+               DEBUG_CALLBACK_HAC(F("Connection attempt timeout."));
+               this->_recordConnectFailure();
+               this->_connectNextCandidate();
+               return;
+          }
+          if (this->_dhcpRestartCount >= this->_dhcpMaxRestart)
+          {
+               DEBUG_CALLBACK_HAC(F("DHCP stalled."));
+               this->_connectNextCandidate();
+               return;
+          }
+
+          this->_dhcpRestartCount++;
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG130, millis() - this->_staAttemptStart, this->_dhcpRestartCount);
+          __STA_DHCP_RESTART__();
      }
+
+     HAC_FLOW_END(this->_attemptFlow);
 }
 
 /**
-     * Setting up wifi configuration based on the mode   
+     * Checking if the SDK reports a failure of the connection attempt.
+     * @param status Station status
+     * @return True if the attempt failed else False
      */
-void HaCWifiManager::_initStation(bool isStartUp)
+bool HaCWifiManager::_isAttemptFailed(wl_status_t status)
 {
-     if(!this->_wifiParam)this->_initParam();
-     if(!this->_wifiParam) return;
+     //Status may still hold the previous attempt result right after the start
+     if (millis() - this->_staAttemptStart < CONNECT_ABORT_GRACE) return false;
 
-     DEBUG_CALLBACK_HAC(F("Initializing station.."));
-     //Check if it is multi or single wifi
-     if (this->_wifiParam->getEnableMultiWifi())
-          this->_setupSTAMultiWifi(isStartUp);
-     else
-          this->_setupSTASingleWifi(isStartUp);
+     return status == WL_CONNECT_FAILED ||
+     #ifdef ESP8266
+            status == WL_WRONG_PASSWORD ||
+     #endif
+            status == WL_NO_SSID_AVAIL;
 }
 
 /**
-     * Setting multi wifi mode.     
+     * Configure the remembered DHCP lease of a network statically.
+     * @param ssid Network ssid
+     * @return True if a valid lease has been configured else False
      */
-void HaCWifiManager::_setupSTAMultiWifi(bool isStartup)
+bool HaCWifiManager::_applyLease(const char *ssid)
 {
-     //If there is only one ssid on the list then set it up as a single wifi
-     if (this->_wifiParam->getWifiListCount() == 1)
+     t_networkStats *stats = this->_networkStats.get(ssid, false);
+     if (!stats || !stats->lease.valid) return false;
+
+     unsigned long age = millis() - stats->lease.obtainedAt;
+     if (age > this->_leaseMaxAgeMs || (stats->lease.leaseTimeS && age / 1000 >= stats->lease.leaseTimeS))
      {
-          this->_setupSTASingleWifi(isStartup);
-          return;
+          //Expired lease, get a fresh one from DHCP
+          stats->lease.valid = false;
+          return false;
      }
-     DEBUG_CALLBACK_HAC(F("Setting up STA multi wifi.."));
 
-     //Clean previous scan
-     WiFi.scanDelete();
-     DEBUG_CALLBACK_HAC(F("Deleted previous scan."));
-     //Remove previous wifi ssid&password
-     WiFi.disconnect();
-     DEBUG_CALLBACK_HAC(F("Previous wifi session ssid/password."));
-     //Start wifi scan
-     WiFi.scanNetworks(true);
-     DEBUG_CALLBACK_HAC(F("Start wifi scan in async mode"));
+     t_dhcpLease &lease = stats->lease;
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG132, IPAddress(lease.ip).toString().c_str(), age);
+     if (!WiFi.config(IPAddress(lease.ip), IPAddress(lease.gw), IPAddress(lease.sn),
+                      IPAddress(lease.dns1), IPAddress(lease.dns2)))
+     {
+          DEBUG_CALLBACK_HAC(F("DHCP lease configuration failed."));
+          return false;
+     }
+     return true;
+}
 
-     this->_wifiScanCountAttempt = 0;
-     
-     this->_wifiScanTimer.onTick([&]()
-                                 {
-                                      int8_t count = WiFi.scanComplete();
-                                      if (count < 0)
-                                      {
-                                           this->_wifiScanCountAttempt++;
-
-                                           //Raise error if wifi scan fail for max attempt
-                                           if (this->_wifiScanCountAttempt > MAX_WIFI_SCAN_ATTEMPT)
-                                           {
-                                                this->_wifiScanFail = true;
-                                                this->_printError(11);
-                                                DEBUG_CALLBACK_HAC(F("Wifi scan failed or timeout."));
-                                                this->_wifiScanTimer.stop();
-                                           }
-                                           return;
-                                      }
-
-                                      //Continue scanning until count return other than 255 and 0
-                                      if (count != 255 && count > 0)
-                                           this->_wifiScanTimer.stop();
-                                      else
-                                           return;
-                                   
-                                      DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG104, count);
-
-                                      if (!this->_scanWifiListRssi(count))
-                                      {
-                                           DEBUG_CALLBACK_HAC(F("Warning: None of ssid listed was found from the scanning."));
-                                           this->_printError(12);
-                                      }
-                                      else
-                                           this->_sortWifiRssi();
-
-                                      this->_setupSTASingleWifi();
-
-                                      DEBUG_CALLBACK_HAC(F("Multiwifi setup done."));
-                                 });
-     this->_wifiScanTimer.begin();
-}
-/**
-     * Scan wifi rssi.     
-     * @param totalAP- Total number of access point scanned
+/**
+     * Remember the DHCP lease of the connected network.
+     * Note: The lease time is the one granted by the DHCP server, 0 if it is unknown.
+     * @param ssid Network ssid
      */
-bool HaCWifiManager::_scanWifiListRssi(uint8_t totalAP)
+void HaCWifiManager::_storeLease(const char *ssid)
 {
-     if(!this->_wifiParam)return false;
+     t_networkStats *stats = this->_networkStats.get(ssid);
+     stats->lease.ip = WiFi.localIP();
+     stats->lease.sn = WiFi.subnetMask();
+     stats->lease.gw = WiFi.gatewayIP();
+     stats->lease.dns1 = WiFi.dnsIP(0);
+     stats->lease.dns2 = WiFi.dnsIP(1);
+     stats->lease.obtainedAt = millis();
+     stats->lease.leaseTimeS = this->_callStationNetif(NETIF_DHCP_LEASE, this->_leaseDhcpNetif ? &this->_leaseDhcpNetif : nullptr);
+     stats->lease.valid = stats->lease.ip != 0;
+}
 
-     String ssid;
-     int32_t rssi;
-     uint8_t encType;
-     uint8_t *bssid;
-     int32_t channel;
-     #ifdef ESP8266
-     bool hidden;
-     #endif
-     bool atleastOneSsidListFoundFlag = false;
+/**
+     * Verify that the gateway answered and that no other host holds the address on a reused lease,
+     * otherwise fall back to DHCP.
+     */
+void HaCWifiManager::_verifyLease()
+{
+     this->_leaseVerifyTimer.stop();
+     if (!this->_staLeaseApplied || WiFi.status() != WL_CONNECTED) return;
 
-     DEBUG_CALLBACK_HAC(F("Scanning Wifi AP Rssi.."));
-     for (uint8_t i = 0; i < totalAP; i++)
+     bool conflict = this->_callStationNetif(NETIF_ARP_CONFLICT) != 0;
+     if (!conflict && this->_callStationNetif(NETIF_ARP_GATEWAY))
      {
-          // Get network information
-          #ifdef ESP8266
-          WiFi.getNetworkInfo(i, ssid, encType, rssi, bssid, channel, hidden);
-          #endif
-          #ifdef ESP32
-          WiFi.getNetworkInfo(i, ssid, encType, rssi, bssid, channel);
-          #endif
-
-          // Check if the WiFi network contains an entry in Wifiinfo list
-          uint8_t j = 0;
-          for (auto entry : this->_wifiParam->wifiInfo)
+          DEBUG_CALLBACK_HAC(F("DHCP lease verified."));
+          //Take the lease over from DHCP without dropping the address
+          if (this->_callStationNetif(NETIF_DHCP_START, &this->_leaseDhcpNetif))
           {
-               // Check SSID
-               if (ssid == entry.ssid)
-               {
-                    // Known network
-                    atleastOneSsidListFoundFlag = true;
-                    this->_wifiParam->wifiInfo[j].rssi = WiFi.RSSI(i);
-                    DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG105, ssid.c_str());
-                    DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG106, this->_wifiParam->wifiInfo[j].rssi);
-               }
-               j++;
+               this->_leaseRenewing = true;
+               this->_leaseRenewTimer.begin();
           }
+          return;
      }
 
-     return atleastOneSsidListFoundFlag;
+     if (conflict)
+     {
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG141, WiFi.localIP().toString().c_str());
+     }
+     else
+     {
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG133, WiFi.gatewayIP().toString().c_str());
+     }
+     t_networkStats *stats = this->_networkStats.get(WiFi.SSID().c_str(), false);
+     if (stats) stats->lease.valid = false;
+
+     //Restore the DHCP client
+     WiFi.config(IPAddress(), IPAddress(), IPAddress());
+     this->_staLeaseApplied = false;
+     this->_manualStaNetworkSetupSuccess = false;
 }
 
 /**
-     * Sort wifi list from strongest to weakest rssi.     
-     * @param totalAP- Total number of access point scanned
+     * Checking the background DHCP started on a reused lease, the lease is remembered once it is bound.
      */
-void HaCWifiManager::_sortWifiRssi()
+void HaCWifiManager::_renewLease()
 {
-     if(!this->_wifiParam)return;
-
-     DEBUG_CALLBACK_HAC(F("Sorting Wifi AP based on Rssi"));
-     for (uint8_t i = 0; i < this->_wifiParam->getWifiListCount(); i++)
+     if (!this->_leaseRenewing) return;
+     if (WiFi.status() != WL_CONNECTED)
      {
-          for (uint8_t j = 0; j < this->_wifiParam->getWifiListCount(); j++)
-          {
-               if (this->_wifiParam->wifiInfo[i].rssi > this->_wifiParam->wifiInfo[j].rssi)
-               {
-                    t_wifiInfo tmp;
-
-               tmp = this->_wifiParam->wifiInfo[i];
-                    this->_wifiParam->wifiInfo[i] = this->_wifiParam->wifiInfo[j];
-                    this->_wifiParam->wifiInfo[j] = tmp;
-               }
-          }
+          this->_stopLeaseDhcp();
+          return;
      }
 
-     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG107, this->_wifiParam->wifiInfo[0].ssid.c_str());
+     uint32_t leaseTimeS = this->_callStationNetif(NETIF_DHCP_LEASE, &this->_leaseDhcpNetif);
+     if (leaseTimeS == 0) return;
+
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG142, WiFi.localIP().toString().c_str(), (unsigned long)leaseTimeS);
+     this->_leaseRenewTimer.stop();
+     this->_leaseRenewing = false;
+     this->_storeLease(WiFi.SSID().c_str());
 }
 
 /**
-     * Setting single wifi mode.     
+     * Stopping the background DHCP of a reused lease before the station is configured again.
      */
-void HaCWifiManager::_setupSTASingleWifi(bool isStartUp)
+void HaCWifiManager::_stopLeaseDhcp()
 {
-     if(!this->_wifiParam)this->_initParam();
-     if(!this->_wifiParam)return;
+     this->_leaseRenewTimer.stop();
+     this->_leaseRenewing = false;
+     if (!this->_leaseDhcpNetif) return;
 
-     DEBUG_CALLBACK_HAC(F("Setting up single STA wifi.."));
-     if (isStartUp)
+     this->_callStationNetif(NETIF_DHCP_STOP, &this->_leaseDhcpNetif);
+     this->_leaseDhcpNetif = nullptr;
+}
+
+/**
+     * Running an operation on the station interface.
+     * Note: lwIP is not thread safe on ESP32, the operation runs on the tcpip task.
+     * @param op Operation
+     * @param netif Interface to use, looked up by the station address if not set and returned
+     * @return Operation result, 0 on failure
+     */
+uint32_t HaCWifiManager::_callStationNetif(NetifOperation op, struct netif **netif)
+{
+     t_stationNetifCall call;
+     call.netif = netif ? *netif : nullptr;
+     call.localIp = (uint32_t)WiFi.localIP();
+     call.gateway = (uint32_t)WiFi.gatewayIP();
+     call.op = op;
+     call.result = 0;
+     if (!call.netif && (call.localIp == 0 || call.gateway == 0)) return 0;
+
+     #if defined(ESP32)
+     tcpip_api_call(HaCWifiManager::_stationNetifTcpip, &call.call);
+     #else
+     HaCWifiManager::_stationNetif(&call);
+     #endif
+     if (netif) *netif = call.netif;
+     return call.result;
+}
+
+/**
+     * Operation on the interface holding the station address.
+     * Note: The default interface can be the access point one on AP_STA mode.
+     * @param call Operation and result
+     */
+void HaCWifiManager::_stationNetif(t_stationNetifCall *call)
+{
+     for (struct netif *netif = netif_list; netif != nullptr && !call->netif; netif = netif->next)
      {
-          delay(1000);
-          this->_startStation(this->_wifiParam->wifiInfo[0].ssid.c_str(),
-                              this->_wifiParam->wifiInfo[0].pass.c_str());
+          if (netif_is_up(netif) && ip4_addr_get_u32(netif_ip4_addr(netif)) == call->localIp)
+               call->netif = netif;
      }
-     else //After startup, wifi setup will be done asynchronously
-     {          
-          this->_staStartupTimer.onTick([&]()
-                                        {
-                                             //if(!this->_wifiParam) this->_initParam();
-                                             this->_startStation(this->_wifiParam->wifiInfo[0].ssid.c_str(),
-                                                                 this->_wifiParam->wifiInfo[0].pass.c_str());
-                                             this->_staStartupTimer.stop();
-                                        });
-          this->_staStartupTimer.begin();
+     if (!call->netif) return;
+
+     ip4_addr_t gw, local;
+     ip4_addr_set_u32(&gw, call->gateway);
+     ip4_addr_set_u32(&local, call->localIp);
+     struct eth_addr *ethRet;
+     const ip4_addr_t *ipRet;
+     switch (call->op)
+     {
+     case NETIF_ARP_REQUEST:
+          etharp_request(call->netif, &gw);
+          //Queried to get an entry, only another host holding the address can answer it
+          etharp_query(call->netif, &local, nullptr);
+          break;
+     case NETIF_ARP_GATEWAY:
+          call->result = etharp_find_addr(call->netif, &gw, &ethRet, &ipRet) >= 0;
+          break;
+     case NETIF_ARP_CONFLICT:
+          call->result = etharp_find_addr(call->netif, &local, &ethRet, &ipRet) >= 0;
+          break;
+     case NETIF_DHCP_START:
+          call->result = dhcp_start(call->netif) == ERR_OK;
+          break;
+     case NETIF_DHCP_STOP:
+          dhcp_stop(call->netif);
+          break;
+     case NETIF_DHCP_LEASE:
+          call->result = dhcp_supplied_address(call->netif) ? netif_dhcp_data(call->netif)->offered_t0_lease : 0;
+          break;
      }
 }
 
+#if defined(ESP32)
+err_t HaCWifiManager::_stationNetifTcpip(struct tcpip_api_call_data *call)
+{
+     HaCWifiManager::_stationNetif((t_stationNetifCall *)call);
+     return ERR_OK;
+}
+#endif
+
+/**
+     * Checking if the current connection attempt gets its IP from DHCP.
+     * @return True if DHCP is awaited else False
+     */
+bool HaCWifiManager::_isDhcpAttempt()
+{
+     return this->_wifiParam && this->_wifiParam->getWifiEnableDHCP(this->_staCandidateIndex) &&
+            !this->_staLeaseApplied;
+}
+
+/**
+     * Getting the wait of the IP acquisition phase.
+     * @return DHCP timeout, or what is left of the attempt deadline without DHCP
+     */
+unsigned long HaCWifiManager::_dhcpWaitMs()
+{
+     if (this->_isDhcpAttempt()) return this->_dhcpTimeoutMs;
+
+     unsigned long elapsed = millis() - this->_staAttemptStart;
+     return elapsed < this->_staAttemptDeadlineMs ? this->_staAttemptDeadlineMs - elapsed : 0;
+}
+
 /**
      * Setting station.    
      * @param ssid-const char* wifi station ssid
      * @param pass-const char* wifi station pass 
+     * @param channel-int32_t wifi station channel, 0 if unknown
+     * @param bssid-const uint8_t* wifi station bssid, nullptr if unknown
      */
-void HaCWifiManager::_startStation(const char *ssid, const char *pass)
+void HaCWifiManager::_startStation(const char *ssid, const char *pass, int32_t channel, const uint8_t *bssid)
 {
      if(!this->_wifiParam)return;
+     this->_setupFlow.stop();
 
-     //Check if network set as DHCP for station     
-     if (!(this->_wifiParam->getEnableDHCPNetwork(NETWORK_STATION)))
+     //Do not burn an attempt on a network with failing credentials, nor drop a working link for it
+     if (this->isQuarantined(ssid))
+     {
+          DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG128, ssid);
+          this->_failConnectRequest(CONNECT_QUARANTINED);
+          if (this->_staState.state() != STA_CONNECTED) this->_connectNextCandidate();
+          return;
+     }
+
+     //Leaving a connected access point e.g. roaming
+     if (this->_staState.state() == STA_CONNECTED) this->_onStationDisconnected(false);
+
+     //Apply the network profile of the selected wifi
+     this->_staLeaseApplied = false;
+     this->_leaseVerifyTimer.stop();
+     this->_stopLeaseDhcp();
+     if (!(this->_wifiParam->getWifiEnableDHCP(this->_staCandidateIndex)))
           this->_manualStaNetworkSetupSuccess = this->_setupNetworkManually(NETWORK_STATION);
+     else if (this->_leaseReuseEnable && this->_applyLease(ssid))
+     {
+          this->_staLeaseApplied = true;
+          this->_manualStaNetworkSetupSuccess = true;
+     }
+     else if (this->_manualStaNetworkSetupSuccess)
+     {
+          //Previous network was static, restore the DHCP client
+          WiFi.config(IPAddress(), IPAddress(), IPAddress());
+          this->_manualStaNetworkSetupSuccess = false;
+     }
 
      /* #region Debug */
      DEBUG_CALLBACK_HAC(F("Setting up station.."));
@@ -1064,17 +3412,20 @@ void HaCWifiManager::_startStation(const char *ssid, const char *pass)
      DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG108, pass);
      /* #endregion */
      //Start wifi network
-     WiFi.begin(ssid, pass);
-
-     //Start the station watchdog timer which shall check if the connection
-     //established 30secs later after station startup     
-     this->_staWatchdogTimer.onTick([&]()
-                                   {
-                                        if (!this->_onReadyStateSTAFlagOnce)
-                                             this->_initStation(false);
-                                        this->_staWatchdogTimer.stop();
-                                   });
-     this->_staWatchdogTimer.begin();
+     this->_disconnectReason = 0;
+     this->_staAssociated = false;
+     this->_dhcpRestartCount = 0;
+     WiFi.begin(ssid, pass, channel, bssid);
+
+     this->_setStaState(STA_ASSOCIATING);
+     this->_staAttemptStart = millis();
+
+     //The attempt flow checks if the connection established within the deadline
+     //learned for this network, otherwise the next ranked candidate is tried
+     bool lastCandidate = this->_nextCandidateIndex() >= this->_wifiParam->getWifiListCount();
+     this->_staAttemptDeadlineMs = this->_connectDeadline(ssid, lastCandidate);
+     DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG122, this->_staAttemptDeadlineMs);
+     this->_attemptFlow.restart();
 }
 
 /**
@@ -1086,7 +3437,7 @@ bool HaCWifiManager::_setupNetworkManually(NetworkType netWorkType)
 
      t_networkInfo netInfo;
      if(netWorkType == NETWORK_STATION) 
-          netInfo = this->_wifiParam->staNetworkInfo;     
+          netInfo = this->_wifiParam->getWifiNetworkInfo(this->_staCandidateIndex);
      if(netWorkType == NETWORK_AP) 
           netInfo = this->_wifiParam->apNetworkInfo;     
 
@@ -1200,10 +3551,10 @@ void HaCWifiManager::_initParam()
 {
      this->_wifiParam = new HACWifiManagerParameters();
 
-     char *data = new char[2000];
-     memset(data, '\0', 2000);
+     char *data = new char[PARAMETERS_JSON_SIZE];
+     memset(data, '\0', PARAMETERS_JSON_SIZE);
 
-     this->_read(data);
+     this->_read(data, PARAMETERS_JSON_SIZE);
 
      if(data[0] == '\0') 
           DEBUG_CALLBACK_HAC(F("Invalid parameters retrieved.."));
@@ -1218,14 +3569,14 @@ void HaCWifiManager::_initParam()
      */
 void HaCWifiManager::_save()
 {
-     char *data = new char[1000];
-     memset(data, '\0', 1000);
+     char *data = new char[PARAMETERS_JSON_SIZE];
+     memset(data, '\0', PARAMETERS_JSON_SIZE);
 
-     this->_read(data);
+     this->_read(data, PARAMETERS_JSON_SIZE);
 
-     char *wifiConfig = new char[1000];
-     memset(wifiConfig, '\0', 1000);
-     this->getWifiConfigJson(wifiConfig, 2000);
+     char *wifiConfig = new char[PARAMETERS_JSON_SIZE];
+     memset(wifiConfig, '\0', PARAMETERS_JSON_SIZE);
+     this->getWifiConfigJson(wifiConfig, PARAMETERS_JSON_SIZE);
      
      if(strcmp(&data[0], &wifiConfig[0]) == 0 && data[0] != '\0')
      {
@@ -1235,8 +3586,11 @@ void HaCWifiManager::_save()
           return;
      } 
      
+     delete[] data;
+
      if(!__LITTLEFS__.begin()){    
           DEBUG_CALLBACK_HAC(F("An Error has occurred while mounting LITTLEFS!"));        
+          delete[] wifiConfig;
           return;
      }
 
@@ -1246,19 +3600,21 @@ void HaCWifiManager::_save()
      File file = __LITTLEFS__.open(___FILE_NAME___, "w+");
      if(!file){
           DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG20, ___FILE_NAME___);
+          delete[] wifiConfig;
           return;
      }       
 
      if(!file.print(&wifiConfig[0]))
      {
           DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG21, ___FILE_NAME___);
+          delete[] wifiConfig;
+          file.close();
           return;
      }
 
      DEBUG_CALLBACK_HAC2(HAC_WFM_VERBOSE_MSG22, ___FILE_NAME___);
 
      delete[] wifiConfig;
-     delete[] data;
 
      file.close();
      __LITTLEFS__.end();
@@ -1267,9 +3623,11 @@ void HaCWifiManager::_save()
 
 /**
      * Read parameters.  
+     * Note: A file longer than the buffer is truncated.
      * @param data parameter buffer   
+     * @param size parameter buffer size
      */
-void HaCWifiManager::_read(char *data)
+void HaCWifiManager::_read(char *data, uint16_t size)
 {
      if(!__LITTLEFS__.begin()){    
           DEBUG_CALLBACK_HAC(F("An Error has occurred while mounting LITTLEFS!"));        
@@ -1286,13 +3644,128 @@ void HaCWifiManager::_read(char *data)
      }  
 
      uint16_t i=0;
-     while(file.available()) data[i++] = (char)file.read();
+     while(file.available() && i < size - 1) data[i++] = (char)file.read();
 
-     data[i++] = '\0'; 
+     data[i] = '\0'; 
           
      file.close();
 
      __LITTLEFS__.end();
 
 }
+
+/**
+     * Constructor.
+     * @param manager Manager running the request
+     * @param id Request id, 0 if the request could not be queued
+     * @param rejected Result of a request which could not be queued
+     */
+HaCConnectHandle::HaCConnectHandle(HaCWifiManager *manager, uint32_t id, ConnectResult rejected)
+    : _manager(manager), _id(id), _rejected(rejected)
+{
+}
+
+/**
+     * Checking if the request is done.
+     * @return True if the request is done else False
+     */
+bool HaCConnectHandle::isDone()
+{
+     return this->result() != CONNECT_PENDING;
+}
+
+/**
+     * Getting the request result.
+     * @return Request result, CONNECT_PENDING until done
+     */
+ConnectResult HaCConnectHandle::result()
+{
+     if (!this->_manager || !this->_id) return this->_rejected;
+
+     t_connectOperation operation;
+     if (this->_manager->_readConnectOperation(this->_id, operation)) return operation.result;
+
+     //History still holds an older request, this one is queued
+     return (int32_t)(operation.id - this->_id) < 0 ? CONNECT_PENDING : CONNECT_EXPIRED;
+}
+
+/**
+     * Getting the time from the request start to its completion.
+     * @return Elapsed time in millisecond, 0 until done
+     */
+unsigned long HaCConnectHandle::elapsedMs()
+{
+     t_connectOperation operation;
+     return this->get(operation) ? operation.elapsedMs : 0;
+}
+
+/**
+     * Getting the access point joined by a connect request.
+     * @param bssid Bssid, 6 bytes
+     * @return True if the request joined an access point else False
+     */
+bool HaCConnectHandle::getBssid(uint8_t *bssid)
+{
+     t_connectOperation operation;
+     if (!this->get(operation) || operation.result != CONNECT_OK || operation.type != REQUEST_CONNECT) return false;
+
+     memcpy(bssid, operation.bssid, 6);
+     return true;
+}
+
+/**
+     * Getting the channel joined by a connect request.
+     * @return Channel, 0 if the request did not join an access point
+     */
+int32_t HaCConnectHandle::getChannel()
+{
+     t_connectOperation operation;
+     return this->get(operation) ? operation.channel : 0;
+}
+
+/**
+     * Getting the request record.
+     * @param operation Record
+     * @return False if the request is not started yet or expired
+     */
+bool HaCConnectHandle::get(t_connectOperation &operation)
+{
+     if (!this->_manager || !this->_id) return false;
+
+     return this->_manager->_readConnectOperation(this->_id, operation);
+}
+
+/**
+     * Wait for the request to be done.
+     * Note: Without task mode the manager loop is run here, it must not be called from a
+     * manager event. On task mode the queued events are delivered while waiting.
+     * @param timeoutMs Longest wait in millisecond, 0 waits until done
+     * @return Request result, CONNECT_PENDING on timeout
+     */
+ConnectResult HaCConnectHandle::wait(unsigned long timeoutMs)
+{
+     unsigned long start = millis();
+     ConnectResult result = this->result();
+     while (result == CONNECT_PENDING && this->_manager)
+     {
+          if (timeoutMs && millis() - start >= timeoutMs) break;
+
+          this->_manager->loop();
+          if (this->_manager->isTaskMode()) delay(1);
+          else yield();
+          result = this->result();
+     }
+     //On task mode the events raised before the completion are delivered too
+     if (this->_manager && this->_manager->isTaskMode()) this->_manager->loop();
+     return result;
+}
+
+/**
+     * Getting the request id.
+     * @return Request id, 0 if the request could not be queued
+     */
+uint32_t HaCConnectHandle::id()
+{
+     return this->_id;
+}
 /* #endregion */
\ No newline at end of file
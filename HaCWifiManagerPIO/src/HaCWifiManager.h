@@ -30,7 +30,40 @@
 /* #region Debug */
 #define HAC_DEBUG_PREFIX "[HACWIFIMANAGER]"
 #define DEFAULT_HOST_NAME "HACWIFIMNGRHOST"
-#define WIFI_SCAN_TIMEOUT 1000  
+#define WIFI_SCAN_TIMEOUT 1000                   // Scan safety net period, scan completion is event driven
+#define STARTUP_SETTLE_DELAY 1000                // Radio settle time before the station or the access point is brought up
+#define CONNECT_ATTEMPT_TIMEOUT 8000             // Timeout of a single connection attempt before moving to the next candidate
+#define WATCHDOG_FLOOR 3000                      // Minimum station watchdog deadline
+#define WATCHDOG_CEILING 30000                   // Maximum station watchdog deadline, used until a network has history
+#define WATCHDOG_K 3.0f                          // Standard deviations added to the mean time to IP
+#define DHCP_TIMEOUT 5000                        // Time to get an IP once associated before the DHCP is restarted
+#define DHCP_MAX_RESTART 1                       // DHCP restarts before moving to the next candidate
+#define LEASE_REUSE_MAX_AGE 3600000              // Remembered DHCP lease older than this is not reused
+#define LEASE_VERIFY_TIMEOUT 1500                // Time for the gateway to answer the ARP request on a reused lease
+#define LEASE_RENEW_POLL 5000                    // Period the background DHCP is checked on a reused lease
+#define CONNECT_ABORT_GRACE 500                  // Connection failure status is ignored right after the attempt started
+#define MDNS_SERVICE_INTERVAL 100                // Longest loop pause while MDNS has to be serviced
+#define LOOP_BUDGET_MAX_DEFER 50                 // Deferred work runs anyway after this many loop passes
+#define HAC_TASK_CORE 0                          // Manager task core, the Arduino loop runs on core 1
+#define HAC_TASK_STACK_SIZE 6144
+#define HAC_TASK_PRIORITY 1
+#define HAC_TASK_MAX_SLEEP 10                    // Longest manager task sleep, wifi status changes are polled
+#define HAC_EVENT_QUEUE_SIZE 16                  // Events queued on task mode or deferred dispatch, power of two
+#define HAC_EVENT_DATA_SIZE 96                   // Longer queued event data is truncated
+#define HAC_EVENT_STATE_RESERVE 4                // Queue slots kept for the state events, debug events are dropped first
+#define STATUS_REFRESH_INTERVAL 1000             // Rssi and access point client refresh period of the status snapshot
+#define HAC_CONNECT_QUEUE_SIZE 4                 // Connect and disconnect requests waiting for the manager loop, power of two
+#define HAC_CONNECT_HISTORY 4                    // Completed requests kept for their handles
+#define BACKGROUND_SCAN_INTERVAL 60000           // Background scan period while the station is connected
+#define ROAM_RSSI_THRESHOLD -75                  // Rssi below which roaming looks for a better access point
+#define ROAM_HYSTERESIS 8                        // Minimum rssi gain in dB to roam
+#define ROAM_MIN_DWELL 60000                     // Minimum time on an access point before roaming away
+#define ROAM_SAMPLE_INTERVAL 5000                // Rssi sampling period while connected
+#define ROAM_LOW_SAMPLES 3                       // Consecutive weak samples before roaming
+#define ROAM_SCAN_INTERVAL 30000                 // Minimum period between two roaming scans
+#define PARAMETERS_JSON_SIZE 2000                // Parameter file buffer, fits a full wifi list with network profiles
+#define MAX_FALLBACK_LIST 5                      // Maximum fallback candidates kept from the background scan
+#define FALLBACK_LIST_MAX_AGE (3 * BACKGROUND_SCAN_INTERVAL) // Fallback candidates older than this are not used
 #ifdef ESP8266 
 #define MAX_WIFI_SCAN_ATTEMPT 3
 #endif
@@ -85,6 +118,13 @@
 #include "HaCWifiManagerStringConst.h"
 #include "hacwifimanagerparameters.h"
 #include "tick.h"
+#include "scancache.h"
+#include "networkstats.h"
+#include "backoff.h"
+#include "stationstate.h"
+#include "hacflow.h"
+#include "spscring.h"
+#include "seqlock.h"
 /* #endregion */
 
 /* #region EXTERNAL_DEPENDENCY */
@@ -97,8 +137,110 @@
 #define ___FILE_NAME___ "/wifi.info"
 #define ___DEF_SSID___ "myIOTAP"
 #define ___DEF_PASS___ "password"
-typedef std::function<void()> tListGenCbFnHaC;                      // Standard void function with non-return value
-typedef std::function<void(const char *)> tListGenCbFnHaC1StrParam; // Standard void function with non-return value
+typedef HaCFunction<void()> tListGenCbFnHaC;                      // Standard void function with non-return value
+typedef HaCFunction<void(const char *)> tListGenCbFnHaC1StrParam; // Standard void function with non-return value
+
+typedef struct WifiCandidate
+{
+    String ssid;
+    uint8_t bssid[6];
+    int32_t channel;
+    int8_t rssi;
+} t_wifiCandidate;
+
+enum HaCEventType
+{
+    HAC_EVENT_DEBUG,
+    HAC_EVENT_ERROR,
+    HAC_EVENT_STA_READY,
+    HAC_EVENT_STA_DISCONNECT,
+    HAC_EVENT_AP_READY,
+    HAC_EVENT_AP_DISCONNECT,
+    HAC_EVENT_AP_NEW_CONNECTION,
+    HAC_EVENT_QUARANTINE
+};
+
+typedef struct HaCEvent
+{
+    HaCEventType type = HAC_EVENT_DEBUG;
+    unsigned long timestamp = 0;    // millis() when the event was raised
+    char data[HAC_EVENT_DATA_SIZE];
+} t_hacEvent;
+
+typedef struct EventStats
+{
+    unsigned long queued = 0;
+    unsigned long dispatched = 0;
+    unsigned long dropped = 0;      // Events lost as the queue was full
+    unsigned long depth = 0;        // Events waiting on the last dispatch
+    unsigned long maxDepth = 0;
+    unsigned long maxDelayMs = 0;   // Longest time from raise to dispatch
+} t_eventStats;
+
+typedef struct WifiStatus
+{
+    StationState state = STA_IDLE;
+    bool staConnected = false;
+    bool apStarted = false;
+    char ssid[33] = {0};
+    uint8_t bssid[6] = {0};
+    int32_t channel = 0;
+    int8_t rssi = 0;
+    uint32_t staIp = 0;
+    uint32_t staSubnet = 0;
+    uint32_t staGateway = 0;
+    uint32_t dns1 = 0;
+    uint32_t dns2 = 0;
+    char apSsid[33] = {0};
+    uint32_t apIp = 0;
+    uint32_t apSubnet = 0;
+    uint32_t apGateway = 0;
+    uint8_t apClients = 0;
+    unsigned long staConnectedAt = 0; // millis() when the station got ready, station uptime is millis() - staConnectedAt
+    unsigned long updatedAt = 0;      // millis() of the last snapshot update
+} t_wifiStatus;
+
+typedef struct LoopStats
+{
+    unsigned long calls = 0;
+    unsigned long overruns = 0;     // Calls longer than the loop budget
+    unsigned long overrunUs = 0;    // Total time spent over the loop budget
+    unsigned long lastUs = 0;
+    unsigned long maxUs = 0;
+    unsigned long deferred = 0;     // Work postponed to a later call to respect the loop budget
+} t_loopStats;
+
+typedef struct ReloadResult
+{
+    bool applied = false;           // False if the new parameters are invalid
+    bool staRestarted = false;
+    bool apRestarted = false;
+    unsigned long staDowntimeMs = 0; // Known once the station is ready again
+    unsigned long apDowntimeMs = 0;
+} t_reloadResult;
+
+// Reason codes reported by the SDK on station disconnect, common to ESP8266 and ESP32
+#define DISCONNECT_REASON_AUTH_EXPIRE 2
+#define DISCONNECT_REASON_ASSOC_EXPIRE 4
+#define DISCONNECT_REASON_4WAY_HANDSHAKE_TIMEOUT 15
+#define DISCONNECT_REASON_BEACON_TIMEOUT 200
+#define DISCONNECT_REASON_NO_AP_FOUND 201
+#define DISCONNECT_REASON_AUTH_FAIL 202
+#define DISCONNECT_REASON_ASSOC_FAIL 203
+#define DISCONNECT_REASON_HANDSHAKE_TIMEOUT 204
+
+enum DisconnectAction
+{
+    RECOVER_RESCAN = 0,         // Rescan and rank the wifi list, default recovery
+    RECOVER_SAME_BSSID = 1,     // Transient drop, reconnect to the same access point after a short jitter
+    RECOVER_NEXT_CANDIDATE = 2, // Access point refused us, skip to the next candidate
+};
+
+typedef struct DisconnectRecovery
+{
+    uint8_t reason;
+    DisconnectAction action;
+} t_disconnectRecovery;
 
 enum WifiMode
 {
@@ -107,13 +249,104 @@ enum WifiMode
     BOTH_STA_AP = 3, // Both station and access point mode
 };
 
+enum ConnectRequestType
+{
+    REQUEST_CONNECT = 0,
+    REQUEST_DISCONNECT = 1,
+};
+
+enum ConnectResult
+{
+    CONNECT_PENDING = 0,      // Request queued or running
+    CONNECT_OK = 1,
+    CONNECT_UNKNOWN_SSID = 2, // Ssid not on the wifi list and no password given
+    CONNECT_QUARANTINED = 3,  // Network is quarantined after repeated authentication failures
+    CONNECT_NOT_FOUND = 4,    // Access point not found
+    CONNECT_AUTH_FAILED = 5,
+    CONNECT_TIMEOUT = 6,
+    CONNECT_FAILED = 7,       // Association lost or DHCP stalled
+    CONNECT_CANCELLED = 8,    // Replaced by a later request or by a station shutdown
+    CONNECT_QUEUE_FULL = 9,
+    CONNECT_EXPIRED = 10,     // Request dropped from the history, or invalid handle
+};
+
+typedef struct ConnectRequest
+{
+    uint32_t id = 0;
+    ConnectRequestType type = REQUEST_CONNECT;
+    char ssid[33] = {0};
+    char pass[65] = {0};
+    bool hasPass = false;            // False to use the password of the wifi list
+} t_connectRequest;
+
+typedef struct ConnectOperation
+{
+    uint32_t id = 0;
+    ConnectRequestType type = REQUEST_CONNECT;
+    ConnectResult result = CONNECT_PENDING;
+    unsigned long startedAt = 0;
+    unsigned long elapsedMs = 0;     // Set on completion
+    uint8_t bssid[6] = {0};          // Access point joined on success
+    int32_t channel = 0;
+} t_connectOperation;
+
+typedef enum NetifOperation
+{
+    NETIF_ARP_REQUEST = 0,          // ARP requests for the gateway and for the station address
+    NETIF_ARP_GATEWAY = 1,          // Gateway on the ARP table
+    NETIF_ARP_CONFLICT = 2,         // Another host answered for the station address
+    NETIF_DHCP_START = 3,           // DHCP client started in the background, the address is kept
+    NETIF_DHCP_STOP = 4,
+    NETIF_DHCP_LEASE = 5            // Lease time in second, 0 until DHCP supplied the address
+} NetifOperation;
+
+typedef struct StationNetifCall
+{
+    #if defined(ESP32)
+    struct tcpip_api_call_data call; // First member, the call runs on the tcpip task
+    #endif
+    struct netif *netif;             // Looked up by the station address if not set
+    uint32_t localIp;
+    uint32_t gateway;
+    NetifOperation op;
+    uint32_t result;
+} t_stationNetifCall;
+
 
 
 /* #endregion */
 
 /* #region CLASS_DECLARATION */
+class HaCWifiManager;
+
+/**
+ * Handle of an asynchronous connect or disconnect request.
+ * Note: A handle is a request id, it can be copied freely and polled from any task.
+ */
+class HaCConnectHandle
+{
+public:
+    HaCConnectHandle(HaCWifiManager *manager = nullptr, uint32_t id = 0, ConnectResult rejected = CONNECT_EXPIRED);
+
+    bool isDone();
+    ConnectResult result();
+    unsigned long elapsedMs();           // Time from the request start to its completion
+    bool getBssid(uint8_t *bssid);       // False if the request did not join an access point
+    int32_t getChannel();
+    bool get(t_connectOperation &operation); // False if the request is not started yet or expired
+    ConnectResult wait(unsigned long timeoutMs = 0); // Run or await the manager until done, 0 waits forever
+    uint32_t id();
+
+private:
+    HaCWifiManager *_manager;
+    uint32_t _id;
+    ConnectResult _rejected;            // Result of a request which could not be queued
+};
+
 class HaCWifiManager
 {
+    friend class HaCConnectHandle;
+
 public:
     HaCWifiManager(); // Constructor
     ~HaCWifiManager();
@@ -140,6 +373,8 @@ public:
         );
     
     void setup(); // Function called on setting up the wifi manager Core
+    t_reloadResult reload(const char *wifiJsonStr); // Apply new parameters, only the changed parts are restarted
+    const t_reloadResult &getLastReloadResult();
 
     void loop(); // Function called at the loop routine of the wifi
                  // manager
@@ -173,6 +408,9 @@ public:
     bool editWifiList(const char *oldSsid, const char *oldPass,
                       const char *newSsid, const char *newPass);
     bool removeWifiList(const char *ssid);
+    bool setWifiNetworkProfile(const char *ssid, NetworkProfile profile,
+                               const char *ip = "", const char *sn = "", const char *gw = "",
+                               const char *pdns = "", const char *sdns = "");
 
     
     void shutdownAP();
@@ -190,6 +428,55 @@ public:
     void getDNS2(char *dns2);
     void getSTAWifiSSID(char *ssid);    
     void getAPWifiSSID(char *ssid);
+
+    void setConnectAttemptTimeout(unsigned long timeoutMs = CONNECT_ATTEMPT_TIMEOUT);
+    void setReconnectBackoff(unsigned long baseMs = BACKOFF_BASE, unsigned long capMs = BACKOFF_CAP);
+    void setConnectWatchdog(unsigned long floorMs = WATCHDOG_FLOOR,
+                            unsigned long ceilingMs = WATCHDOG_CEILING,
+                            float k = WATCHDOG_K);
+    unsigned long getConnectDeadline(const char *ssid);
+    void setDhcpTimeout(unsigned long timeoutMs = DHCP_TIMEOUT, uint8_t maxRestart = DHCP_MAX_RESTART);
+    void setLeaseReuse(bool enable = false, unsigned long maxAgeMs = LEASE_REUSE_MAX_AGE);
+    bool getLeaseReuse();
+    void setBackgroundScan(bool enable = false, unsigned long intervalMs = BACKGROUND_SCAN_INTERVAL);
+    bool getBackgroundScan();
+    void setRoaming(bool enable = false,
+                    int8_t rssiThreshold = ROAM_RSSI_THRESHOLD,
+                    uint8_t hysteresisDb = ROAM_HYSTERESIS,
+                    unsigned long dwellMs = ROAM_MIN_DWELL,
+                    unsigned long sampleMs = ROAM_SAMPLE_INTERVAL);
+    bool getRoaming();
+    uint8_t getLastDisconnectReason();
+    StationState getStationState();
+    unsigned long getTimeInState();
+    unsigned long nextWakeupMs(); // Time until the loop has work to do, TICK_NO_DEADLINE if only an event can bring some
+    void setLoopBudget(unsigned long budgetUs); // Time budget of a loop call, 0 for no budget
+    unsigned long getLoopBudget();
+    const t_loopStats &getLoopStats();
+    void resetLoopStats();
+    bool beginTask(uint8_t core = HAC_TASK_CORE,
+                   uint32_t stackSize = HAC_TASK_STACK_SIZE,
+                   uint8_t priority = HAC_TASK_PRIORITY); // Run the manager on its own task
+    void endTask();
+    bool isTaskMode();
+    unsigned long getDroppedEvents();
+    void setDeferredEvents(bool enable = false, uint8_t maxPerLoop = 0); // Deliver events after the manager step, 0 for no limit
+    bool getDeferredEvents();
+    t_eventStats getEventStats();
+    void resetEventStats();
+    unsigned long getEventTime(); // millis() when the event being delivered was raised
+    HaCConnectHandle connectAsync(const char *ssid, const char *pass = nullptr); // Switch to a network of the wifi list
+    HaCConnectHandle disconnectAsync();
+    bool getStatus(t_wifiStatus &status); // Consistent copy of the manager status, safe from any task
+    uint32_t getStatusSequence();         // Changes on every status update
+    bool isQuarantined(const char *ssid);
+    unsigned long getQuarantineRemaining(const char *ssid);
+    void releaseQuarantine(const char *ssid);
+    void setThroughputSensitive(bool sensitive = false);
+    bool getThroughputSensitive();
+    uint8_t getFallbackListCount();
+    void setScanCacheTTL(unsigned long ttlMs = SCAN_CACHE_TTL);
+    const HaCScanCache &getScanCache();
     
     /* Note: Added as per issue #7, https://github.com/SyntaxHarvy/HACWifiManager/issues/7 */
     #if defined(ESP8266)
@@ -213,6 +500,7 @@ public:
     void onAPLoop(tListGenCbFnHaC1StrParam fn);    // either Access point or Station mode
                                                     // point mode
     void onAPNewConnection(tListGenCbFnHaC1StrParam fn);
+    void onQuarantine(tListGenCbFnHaC1StrParam fn); // Event called when a network is quarantined
 private:
 
     HACWifiManagerParameters *_wifiParam = nullptr;       // Private declaration of AMPWifiManagerData
@@ -225,20 +513,110 @@ private:
     tListGenCbFnHaC1StrParam _onAPDisconnectFn;  // Function callback declaration for onDisconnect event
     tListGenCbFnHaC1StrParam _onAPLoopFn; // Function callback declaration for onServiceLoop event
     tListGenCbFnHaC1StrParam _onAPNewConnectionFn; // Function callback declaration for onServiceLoop event
+    tListGenCbFnHaC1StrParam _onQuarantineFn; // Function callback declaration for onQuarantine event
 
-    bool _onReadyStateSTAFlagOnce = false;
     bool _onReadyStateAPFlagOnce = false;
     bool _apFlagStarted = false;
     bool _manualStaNetworkSetupSuccess = false;
     bool _manualApNetworkSetupSuccess = false;
     bool _wifiScanFail = false;
     bool _initMdnsFlagOnce = false;
+    bool _bgScanEnable = false;
+    bool _bgScanRunning = false;
+    bool _throughputSensitive = false;
+    bool _roamEnable = false;
+    bool _roamPending = false;
+    bool _wifiEventsRegistered = false;
+    volatile bool _scanDoneFlag = false;
+    bool _scanCacheBypass = false;      // Next multi wifi setup scans instead of using the scan cache
     enum WifiMode _wifiMode; // Enum Wifi Mode
 
-
-    Tick _wifiScanTimer;
-    Tick _staStartupTimer;
-    Tick _staWatchdogTimer;
+    //Manager timers, declared before the timers they serve, run by the manager loop
+    TickScheduler _timers;
+    TickSchedulerUs _timersUs;
+    Tick _apStartupTimer;
+    HaCFlow _setupFlow;             // Scan, radio settle and first candidate
+    HaCFlow _attemptFlow;           // Association and IP acquisition of a candidate
+    unsigned long _staAttemptDeadlineMs = 0;
+    uint8_t _scanIndex = 0;         // Next scan result collected by the setup flow
+    bool _scanListFound = false;
+    unsigned long _scanItemUs = 0;
+    unsigned long _loopBudgetUs = 0;
+    unsigned long _loopStartUs = 0;
+    t_loopStats _loopStats;
+    bool _savePending = false;
+    uint8_t _saveDeferCount = 0;
+    unsigned long _saveCostUs = 0;  // Worst save time seen
+    bool _taskMode = false;
+    volatile bool _taskStop = false;
+    volatile bool _taskRunning = false;
+    bool _appStaReady = false;      // Station state delivered to the application on task mode
+    bool _appApReady = false;
+    bool _deferEvents = false;
+    uint8_t _eventDispatchLimit = 0;
+    unsigned long _eventTime = 0;       // Raise time of the event being delivered
+    t_eventStats _eventStats;           // Dispatch side, written by the application loop only
+    std::atomic<unsigned long> _eventsQueued{0};   // Queuing side, written by the manager loop
+    std::atomic<unsigned long> _eventsDropped{0};
+    std::atomic<unsigned long> _eventsMaxDepth{0};
+    HaCSpscRing<t_hacEvent, HAC_EVENT_QUEUE_SIZE> *_eventRing = nullptr;
+    HaCSeqLock<t_wifiStatus> _status;   // Written by the manager loop only
+    HaCSpscRing<t_connectRequest, HAC_CONNECT_QUEUE_SIZE> *_connectRing = nullptr;
+    HaCSeqLock<t_connectOperation> _connectHistory[HAC_CONNECT_HISTORY]; // Written by the manager loop only
+    t_connectOperation _connectOp;      // Running request
+    char _connectSsid[33] = {0};
+    uint32_t _connectNextId = 1;        // Used by the requesting task only
+    bool _disconnectRequested = false;  // Station kept down until the SDK reports it
+    std::atomic<bool> _statusDirty{true}; // Set from any task, cleared by the manager loop
+    Tick _statusTimer;
+    #ifdef HAC_TASK_SUPPORT
+    TaskHandle_t _taskHandle = nullptr;
+    #endif
+    Tick _bgScanTimer;
+    Tick _reconnectTimer;
+    Tick _roamTimer;
+    int8_t _roamRssiThreshold = ROAM_RSSI_THRESHOLD;
+    uint8_t _roamHysteresisDb = ROAM_HYSTERESIS;
+    uint8_t _roamLowCount = 0;
+    unsigned long _roamDwellMs = ROAM_MIN_DWELL;
+    unsigned long _connectedSince = 0;
+    unsigned long _lastRoamScan = 0;
+    HaCStationStateMachine _staState;
+    t_reloadResult _lastReload;
+    bool _reloadStaPending = false;
+    unsigned long _reloadStaDownAt = 0;
+    HaCBackoff _reconnectBackoff;
+    unsigned long _connectAttemptTimeoutMs = CONNECT_ATTEMPT_TIMEOUT;
+    unsigned long _watchdogFloorMs = WATCHDOG_FLOOR;
+    unsigned long _watchdogCeilingMs = WATCHDOG_CEILING;
+    float _watchdogK = WATCHDOG_K;
+    unsigned long _dhcpTimeoutMs = DHCP_TIMEOUT;
+    uint8_t _dhcpMaxRestart = DHCP_MAX_RESTART;
+    uint8_t _dhcpRestartCount = 0;
+    volatile bool _staAssociated = false;
+    bool _leaseReuseEnable = false;
+    bool _staLeaseApplied = false;
+    unsigned long _leaseMaxAgeMs = LEASE_REUSE_MAX_AGE;
+    Tick _leaseVerifyTimer;
+    Tick _leaseRenewTimer;
+    bool _leaseRenewing = false;        // Reused lease verified, DHCP runs in the background
+    struct netif *_leaseDhcpNetif = nullptr; // Station interface of the background DHCP
+    HaCNetworkStatsTable _networkStats;
+    unsigned long _staAttemptStart = 0;
+    uint8_t _staCandidateIndex = 0;
+    unsigned long _bgScanIntervalMs = BACKGROUND_SCAN_INTERVAL;
+    unsigned long _fallbackListTimestamp = 0;
+    std::vector<t_wifiCandidate> _fallbackList;
+    HaCScanCache _scanCache;
+    volatile uint8_t _disconnectReason = 0;
+    uint8_t _lastDisconnectReason = 0;
+    uint8_t _connectedBssid[6] = {0};
+    int32_t _connectedChannel = 0;
+    String _connectedSsid;
+    #ifdef ESP8266
+    WiFiEventHandler _staConnectedHandler;
+    WiFiEventHandler _staDisconnectedHandler;
+    #endif
     uint8_t _wifiScanCountAttempt = 0;
     uint8_t _previousAPClientCount = 0;
 
@@ -246,18 +624,82 @@ private:
     void _debug(const char *data); // Function prototype declaration for debug function
     void _debug(const __FlashStringHelper* data);
     void _printError(uint8_t errorCode);
+    void _registerWifiEvents();
     void _initWifiManager();
-    void _initStation(bool isStartUp = true);
-    void _setupSTAMultiWifi(bool isStartUp = true);
-    bool _scanWifiListRssi(uint8_t totalAP);
+    void _initStation();
+    void _setupSTAMultiWifi();
+    bool _startScanAsync();
+    void _handleWifiScan();
+    void _runSetupFlow();
+    bool _scanWifiListRssi(uint8_t index);
     void _sortWifiRssi();
-    void _setupSTASingleWifi(bool isStartUp = true);
+    bool _rankWifiFromScanCache();
+    void _setupSTASingleWifi();
     bool _setupNetworkManually(NetworkType netWorkType);
-    void _startStation(const char *ssid, const char *pass);
+    void _startCandidate(uint8_t index);
+    void _connectNextCandidate();
+    void _seedReconnectBackoff();
+    void _scheduleReconnect(bool sameBssid = false);
+    uint8_t _nextCandidateIndex();
+    unsigned long _connectDeadline(const char *ssid, bool lastCandidate);
+    void _runAttemptFlow(wl_status_t status);
+    bool _isAttemptFailed(wl_status_t status);
+    void _onStationReady();
+    void _onStationDisconnected(bool recover = true);
+    void _onStationLoop();
+    void _startMdns();
+    void _runDeferredWork();
+    void _loopCore();
+    void _raiseEvent(HaCEventType type, const char *data);
+    void _callEvent(HaCEventType type, const char *data);
+    void _dispatchEvents(uint8_t limit = 0);
+    bool _isEventQueued(HaCEventType type);
+    void _publishStatus();
+    bool _isManagerContext();
+    void _readStatus(t_wifiStatus &status);
+    HaCConnectHandle _queueConnectRequest(t_connectRequest &request);
+    void _runConnectRequests(wl_status_t status);
+    void _startConnectRequest(const t_connectRequest &request);
+    void _completeConnectRequest(ConnectResult result);
+    void _failConnectRequest(ConnectResult result = CONNECT_FAILED);
+    bool _readConnectOperation(uint32_t id, t_connectOperation &operation);
+    static void _ipToStr(uint32_t ip, char *str);
+    #ifdef HAC_TASK_SUPPORT
+    static void _taskEntry(void *manager);
+    void _taskLoop();
+    bool _isTaskContext();
+    #endif
+    bool _hasBudget(unsigned long costUs = 0);
+    unsigned long _appWakeupMs();
+    bool _setStaState(StationState next);
+    bool _isDhcpAttempt();
+    unsigned long _dhcpWaitMs();
+    bool _applyLease(const char *ssid);
+    void _storeLease(const char *ssid);
+    void _verifyLease();
+    void _renewLease();
+    void _stopLeaseDhcp();
+    uint32_t _callStationNetif(NetifOperation op, struct netif **netif = nullptr);
+    static void _stationNetif(t_stationNetifCall *call);
+    #if defined(ESP32)
+    static err_t _stationNetifTcpip(struct tcpip_api_call_data *call);
+    #endif
+    void _stopStation();
+    void _startStation(const char *ssid, const char *pass, int32_t channel = 0, const uint8_t *bssid = nullptr);
+    void _startBackgroundScan();
+    void _handleBackgroundScan();
+    bool _connectFallbackCandidate();
+    void _handleRoaming();
+    DisconnectAction _disconnectAction(uint8_t reason);
+    bool _recoverFromDisconnect(uint8_t reason);
+    bool _isAuthFailure();
+    void _recordConnectFailure();
+    void _quarantine(t_networkStats *stats);
+    bool _roamToBetterCandidate(int8_t currentRssi);
     void _startAccessPoint();   
     void _initParam();
     void _save(); 
-    void _read(char *data); 
+    void _read(char *data, uint16_t size); 
    
     
 };
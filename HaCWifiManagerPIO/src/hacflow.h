@@ -0,0 +1,95 @@
+/**
+ *
+ * @file hacflow.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef __HACFLOW_H_
+#define __HACFLOW_H_
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <Arduino.h>
+/* #endregion */
+
+/* #region GLOBAL_VARIABLES */
+#define HAC_FLOW_NO_TIMEOUT ((unsigned long)-1)
+
+// The wait falls through into its own resume point
+#if defined(__GNUC__) && __GNUC__ >= 7
+#define HAC_FLOW_FALLTHROUGH __attribute__((fallthrough))
+#else
+#define HAC_FLOW_FALLTHROUGH
+#endif
+
+/**
+ * Stackless resumable flow, protothread style.
+ * Note: The flow function returns on every wait and is resumed at the same wait on
+ * the next run. Local variables do not survive a wait, keep the state in members,
+ * and do not use switch statements between HAC_FLOW_BEGIN and HAC_FLOW_END.
+ */
+#define HAC_FLOW_BEGIN(flow)         \
+    if (!(flow).isRunning()) return; \
+    switch ((flow).resumePoint())    \
+    {                                \
+    case 0:
+
+// Wait until the condition holds or the timeout in millisecond elapsed
+#define HAC_FLOW_WAIT_UNTIL(flow, cond, timeoutMs)  \
+    (flow).wait(__LINE__, timeoutMs);               \
+    HAC_FLOW_FALLTHROUGH;                           \
+    case __LINE__:                                  \
+        if (!(cond) && !(flow).timedOut()) return;
+
+#define HAC_FLOW_DELAY(flow, delayMs) HAC_FLOW_WAIT_UNTIL(flow, false, delayMs)
+
+// Give the loop back and resume on the next run
+#define HAC_FLOW_YIELD(flow)  \
+    (flow).wait(__LINE__, 0); \
+    return;                   \
+    case __LINE__:
+
+#define HAC_FLOW_END(flow) \
+    }                      \
+    (flow).stop();
+/* #endregion */
+
+/* #region CLASS_DECLARATION */
+class HaCFlow
+{
+public:
+    void restart();                     // Run from the beginning on the next resume
+    void stop();
+    bool isRunning() const;
+    bool timedOut() const;              // The current wait timed out
+    unsigned long timeToTimeout() const; // HAC_FLOW_NO_TIMEOUT if not running
+    uint16_t resumePoint() const;
+    void wait(uint16_t resumePoint, unsigned long timeoutMs);
+
+private:
+    bool _running = false;
+    uint16_t _resumePoint = 0;
+    unsigned long _waitStart = 0;
+    unsigned long _waitTimeout = HAC_FLOW_NO_TIMEOUT;
+};
+/* #endregion */
+
+#include "hacflow-impl.h"
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ *
+ * @file networkstats-impl.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region SELF_HEADER */
+#include "networkstats.h"
+/* #endregion */
+
+/* #region CLASS_DEFINITION */
+HaCConnectEstimator::HaCConnectEstimator(){}
+
+/**
+     * Adding an observed time to IP.
+     * @param durationMs Time from the connection start until the station got an IP.
+     */
+void HaCConnectEstimator::addSample(unsigned long durationMs)
+{
+    if (this->_count < 0xFFFF) this->_count++;
+
+    float alpha = 1.0f / this->_count;
+    if (alpha < CONNECT_ESTIMATOR_ALPHA) alpha = CONNECT_ESTIMATOR_ALPHA;
+
+    float diff = (float)durationMs - this->_mean;
+    this->_mean += alpha * diff;
+    this->_variance = (1.0f - alpha) * (this->_variance + alpha * diff * diff);
+}
+
+/**
+     * Deadline of a connection attempt, mean + k * stddev bounded by floor and ceiling.
+     * Note: The ceiling is returned until the estimator has enough samples.
+     */
+unsigned long HaCConnectEstimator::deadline(float k, unsigned long floorMs, unsigned long ceilingMs) const
+{
+    if (this->_count < CONNECT_ESTIMATOR_MIN_SAMPLES) return ceilingMs;
+
+    float estimate = this->_mean + k * this->stddev();
+    if (estimate < (float)floorMs) return floorMs;
+    if (estimate > (float)ceilingMs) return ceilingMs;
+    return (unsigned long)estimate;
+}
+
+uint16_t HaCConnectEstimator::count() const
+{
+    return this->_count;
+}
+float HaCConnectEstimator::mean() const
+{
+    return this->_mean;
+}
+float HaCConnectEstimator::stddev() const
+{
+    return sqrtf(this->_variance);
+}
+void HaCConnectEstimator::reset()
+{
+    this->_mean = 0;
+    this->_variance = 0;
+    this->_count = 0;
+}
+
+HaCNetworkStatsTable::HaCNetworkStatsTable(){}
+
+/**
+     * Getting the statistics of a network.
+     * Note: When the table is full the least recently used network is replaced. A network
+     * still in quarantine is kept, unless all are, then the earliest released is replaced.
+     * @param ssid Network ssid
+     * @param create Create the entry if not found
+     * @return Network statistics or nullptr if not found and not created
+     */
+t_networkStats *HaCNetworkStatsTable::get(const char *ssid, bool create)
+{
+    for (uint8_t i = 0; i < this->_size; i++)
+    {
+        if (strcmp(this->_entries[i].ssid, ssid) == 0)
+        {
+            this->_entries[i].lastUsed = millis();
+            return &this->_entries[i];
+        }
+    }
+    if (!create) return nullptr;
+
+    t_networkStats *entry;
+    if (this->_size < MAX_NETWORK_STATS)
+        entry = &this->_entries[this->_size++];
+    else
+    {
+        entry = nullptr;
+        unsigned long now = millis();
+        for (uint8_t i = 0; i < this->_size; i++)
+        {
+            t_networkStats *candidate = &this->_entries[i];
+            if (candidate->quarantined && (long)(now - candidate->quarantineUntil) < 0) continue;
+            if (entry == nullptr || (long)(candidate->lastUsed - entry->lastUsed) < 0)
+                entry = candidate;
+        }
+        if (entry == nullptr)
+        {
+            entry = &this->_entries[0];
+            for (uint8_t i = 1; i < this->_size; i++)
+                if ((long)(this->_entries[i].quarantineUntil - entry->quarantineUntil) < 0)
+                    entry = &this->_entries[i];
+        }
+    }
+
+    *entry = t_networkStats();
+    strncpy(entry->ssid, ssid, sizeof(entry->ssid) - 1);
+    entry->ssid[sizeof(entry->ssid) - 1] = '\0';
+    entry->lastUsed = millis();
+    return entry;
+}
+
+void HaCNetworkStatsTable::remove(const char *ssid)
+{
+    for (uint8_t i = 0; i < this->_size; i++)
+    {
+        if (strcmp(this->_entries[i].ssid, ssid) != 0) continue;
+        this->_entries[i] = this->_entries[--this->_size];
+        return;
+    }
+}
+
+void HaCNetworkStatsTable::clear()
+{
+    this->_size = 0;
+}
+/* #endregion */
@@ -0,0 +1,79 @@
+/**
+ *
+ * @file seqlock-impl.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region SELF_HEADER */
+#include "seqlock.h"
+/* #endregion */
+
+/* #region CLASS_DEFINITION */
+template <typename T>
+void HaCSeqLock<T>::write(const T &value)
+{
+    uint32_t seq = this->_seq.load(std::memory_order_relaxed);
+    this->_seq.store(seq + 1, std::memory_order_relaxed);
+    // The odd sequence is visible before any byte of the value changes
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&this->_value, &value, sizeof(T));
+    this->_seq.store(seq + 2, std::memory_order_release);
+}
+
+template <typename T>
+bool HaCSeqLock<T>::tryRead(T &value) const
+{
+    uint32_t seq = this->_seq.load(std::memory_order_acquire);
+    if (seq & 1) return false;
+
+    memcpy(&value, &this->_value, sizeof(T));
+    // The copy completes before the sequence is checked again
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return this->_seq.load(std::memory_order_relaxed) == seq;
+}
+
+template <typename T>
+bool HaCSeqLock<T>::read(T &value) const
+{
+    T copy;
+    for (uint16_t attempt = 0; attempt < HAC_SEQLOCK_MAX_RETRY; attempt++)
+    {
+        if (this->tryRead(copy))
+        {
+            value = copy;
+            return true;
+        }
+        // Let the writer finish, it may run on this core at the same priority
+        #ifdef ESP32
+        taskYIELD();
+        #else
+        yield();
+        #endif
+    }
+    return false;
+}
+
+template <typename T>
+uint32_t HaCSeqLock<T>::sequence() const
+{
+    return this->_seq.load(std::memory_order_acquire);
+}
+/* #endregion */
@@ -0,0 +1,122 @@
+/**
+ *
+ * @file stationstate-impl.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region SELF_HEADER */
+#include "stationstate.h"
+/* #endregion */
+
+/* #region GLOBAL_DEFINITION */
+#define STA_STATE_BIT(state) (1 << (state))
+
+//Allowed next states of each state, a state may always transition to itself
+static const uint8_t HAC_STA_TRANSITIONS[STA_STATE_COUNT] = {
+    /* STA_IDLE */ STA_STATE_BIT(STA_STARTING) | STA_STATE_BIT(STA_SCANNING) | STA_STATE_BIT(STA_ASSOCIATING) |
+        STA_STATE_BIT(STA_CONNECTED) | STA_STATE_BIT(STA_BACKOFF),
+    /* STA_STARTING */ STA_STATE_BIT(STA_IDLE) | STA_STATE_BIT(STA_SCANNING) | STA_STATE_BIT(STA_ASSOCIATING) |
+        STA_STATE_BIT(STA_CONNECTED) | STA_STATE_BIT(STA_BACKOFF),
+    /* STA_SCANNING */ STA_STATE_BIT(STA_IDLE) | STA_STATE_BIT(STA_STARTING) | STA_STATE_BIT(STA_ASSOCIATING) |
+        STA_STATE_BIT(STA_CONNECTED) | STA_STATE_BIT(STA_BACKOFF),
+    /* STA_ASSOCIATING */ STA_STATE_BIT(STA_IDLE) | STA_STATE_BIT(STA_DHCP) | STA_STATE_BIT(STA_CONNECTED) |
+        STA_STATE_BIT(STA_BACKOFF),
+    /* STA_DHCP */ STA_STATE_BIT(STA_IDLE) | STA_STATE_BIT(STA_ASSOCIATING) | STA_STATE_BIT(STA_CONNECTED) |
+        STA_STATE_BIT(STA_BACKOFF),
+    /* STA_CONNECTED */ STA_STATE_BIT(STA_IDLE),
+    /* STA_BACKOFF */ STA_STATE_BIT(STA_IDLE) | STA_STATE_BIT(STA_STARTING) | STA_STATE_BIT(STA_SCANNING) |
+        STA_STATE_BIT(STA_ASSOCIATING) | STA_STATE_BIT(STA_CONNECTED),
+};
+
+static const char *const HAC_STA_STATE_NAMES[STA_STATE_COUNT] = {
+    "IDLE", "STARTING", "SCANNING", "ASSOCIATING", "DHCP", "CONNECTED", "BACKOFF"};
+/* #endregion */
+
+/* #region CLASS_DEFINITION */
+HaCStationStateMachine::HaCStationStateMachine() {}
+
+/**
+     * Move to the next state.
+     * Note: Moving to the current state restarts the time in state.
+     * @param next Next state
+     * @return True if the transition is allowed else False
+     */
+bool HaCStationStateMachine::transition(StationState next)
+{
+    if (!allowed(this->_state, next)) return false;
+
+    this->_state = next;
+    this->_since = millis();
+    return true;
+}
+
+/**
+     * Getting the current state.
+     * @return Current state
+     */
+StationState HaCStationStateMachine::state() const
+{
+    return this->_state;
+}
+
+/**
+     * Getting the time spent on the current state.
+     * @return Time in state in millisecond
+     */
+unsigned long HaCStationStateMachine::timeInState() const
+{
+    return millis() - this->_since;
+}
+
+/**
+     * Checking if a connection attempt is running.
+     * @return True on association or IP acquisition else False
+     */
+bool HaCStationStateMachine::isConnecting() const
+{
+    return this->_state == STA_ASSOCIATING || this->_state == STA_DHCP;
+}
+
+/**
+     * Checking a transition against the transition table.
+     * @param from Current state
+     * @param to Next state
+     * @return True if the transition is allowed else False
+     */
+bool HaCStationStateMachine::allowed(StationState from, StationState to)
+{
+    if (from >= STA_STATE_COUNT || to >= STA_STATE_COUNT) return false;
+    if (from == to) return true;
+
+    return (HAC_STA_TRANSITIONS[from] & STA_STATE_BIT(to)) != 0;
+}
+
+/**
+     * Getting the name of a state.
+     * @param state Station state
+     * @return State name
+     */
+const char *HaCStationStateMachine::name(StationState state)
+{
+    if (state >= STA_STATE_COUNT) return "UNKNOWN";
+    return HAC_STA_STATE_NAMES[state];
+}
+/* #endregion */
@@ -27,24 +27,232 @@
 /* #endregion */
 
 /* #region CLASS_DEFINITION */
-Tick::Tick(){}
-Tick::Tick(unsigned long durationMs){
-    this->_durationMs = durationMs;
+template <typename Clock>
+HaCTickScheduler<Clock> &HaCTickScheduler<Clock>::instance(){
+    static HaCTickScheduler<Clock> scheduler;
+    return scheduler;
 }
-void Tick::begin(){
-    this->_cancel = false;
+template <typename Clock>
+HaCTickScheduler<Clock>::~HaCTickScheduler(){
+    // Timers outliving the scheduler must not reach back into it
+    for(HaCTick<Clock> *tick : this->_heap) tick->_heapIndex = -1;
 }
-void Tick::stop(){
-    this->_cancel = true;
+template <typename Clock>
+void HaCTickScheduler<Clock>::handle(){
+    if(this->_heap.empty()) return;
+
+    unsigned long now = Clock::now();
+    // Only the timers due when the pass started are fired, a zero duration timer rearmed
+    // from its callback is due again and waits for the next pass
+    size_t due = this->_countDue(0, now);
+    while(due-- > 0 && !this->_heap.empty() && (long)(this->_heap[0]->_deadline - now) <= 0)
+        this->_fire(this->_heap[0], now);
 }
-void Tick::onTick(tListGenCbFnTick fn){
-    this->_onTick = fn;
+template <typename Clock>
+size_t HaCTickScheduler<Clock>::size() const{
+    return this->_heap.size();
+}
+template <typename Clock>
+unsigned long HaCTickScheduler<Clock>::timeToNext() const{
+    if(this->_heap.empty()) return TICK_NO_DEADLINE;
+
+    long remaining = (long)(this->_heap[0]->_deadline - Clock::now());
+    return remaining > 0 ? (unsigned long)remaining : 0;
 }
-void Tick::handle(){
-    if(this->_cancel) return;
-    if((millis() - this->_timer) > this->_durationMs){
-        this->_timer = millis(); 
-        if(this->_onTick) this->_onTick();
+template <typename Clock>
+void HaCTickScheduler<Clock>::_schedule(HaCTick<Clock> *tick, unsigned long deadline){
+    tick->_deadline = deadline;
+    if(tick->_heapIndex < 0){
+        tick->_heapIndex = this->_heap.size();
+        this->_heap.push_back(tick);
+        this->_siftUp(tick->_heapIndex);
+    }
+    else{
+        this->_siftUp(tick->_heapIndex);
+        this->_siftDown(tick->_heapIndex);
     }
 }
+template <typename Clock>
+void HaCTickScheduler<Clock>::_remove(HaCTick<Clock> *tick){
+    if(tick->_heapIndex < 0) return;
+
+    size_t index = tick->_heapIndex;
+    size_t last = this->_heap.size() - 1;
+    if(index != last) this->_swap(index, last);
+    this->_heap.pop_back();
+    tick->_heapIndex = -1;
+    if(index < this->_heap.size()){
+        this->_siftUp(index);
+        this->_siftDown(index);
+    }
+}
+// The timer moved in memory, its heap slot follows it
+template <typename Clock>
+void HaCTickScheduler<Clock>::_relocate(HaCTick<Clock> *tick){
+    this->_heap[tick->_heapIndex] = tick;
+}
+template <typename Clock>
+void HaCTickScheduler<Clock>::_fire(HaCTick<Clock> *tick, unsigned long now){
+    // Rescheduled before the callback so the callback may stop or restart the timer
+    if(tick->_mode == TICK_ONE_SHOT) this->_remove(tick);
+    else this->_schedule(tick, tick->_nextDeadline(now));
+
+    // Called from a copy, the callback may reassign or destroy its own timer
+    tListGenCbFnTick fn = tick->_onTick;
+    if(fn) fn();
+}
+// The children of a timer are not due before it, only the due part of the heap is visited
+template <typename Clock>
+size_t HaCTickScheduler<Clock>::_countDue(size_t index, unsigned long now) const{
+    if(index >= this->_heap.size() || (long)(this->_heap[index]->_deadline - now) > 0) return 0;
+    return 1 + this->_countDue(2 * index + 1, now) + this->_countDue(2 * index + 2, now);
+}
+template <typename Clock>
+bool HaCTickScheduler<Clock>::_before(size_t a, size_t b) const{
+    return (long)(this->_heap[a]->_deadline - this->_heap[b]->_deadline) < 0;
+}
+template <typename Clock>
+void HaCTickScheduler<Clock>::_swap(size_t a, size_t b){
+    HaCTick<Clock> *tick = this->_heap[a];
+    this->_heap[a] = this->_heap[b];
+    this->_heap[b] = tick;
+    this->_heap[a]->_heapIndex = a;
+    this->_heap[b]->_heapIndex = b;
+}
+template <typename Clock>
+void HaCTickScheduler<Clock>::_siftUp(size_t index){
+    while(index > 0){
+        size_t parent = (index - 1) / 2;
+        if(!this->_before(index, parent)) break;
+        this->_swap(index, parent);
+        index = parent;
+    }
+}
+template <typename Clock>
+void HaCTickScheduler<Clock>::_siftDown(size_t index){
+    size_t count = this->_heap.size();
+    while(true){
+        size_t smallest = index;
+        size_t left = 2 * index + 1, right = left + 1;
+        if(left < count && this->_before(left, smallest)) smallest = left;
+        if(right < count && this->_before(right, smallest)) smallest = right;
+        if(smallest == index) break;
+        this->_swap(index, smallest);
+        index = smallest;
+    }
+}
+
+template <typename Clock>
+HaCTick<Clock>::HaCTick(){}
+template <typename Clock>
+HaCTick<Clock>::HaCTick(unsigned long duration){
+    this->_duration = duration;
+}
+template <typename Clock>
+HaCTick<Clock>::HaCTick(unsigned long duration, HaCTickScheduler<Clock> &scheduler){
+    this->_duration = duration;
+    this->_scheduler = &scheduler;
+}
+// A copy takes the setup, never the place of the source in the scheduler
+template <typename Clock>
+HaCTick<Clock>::HaCTick(const HaCTick &other){
+    this->_duration = other._duration;
+    this->_mode = other._mode;
+    this->_scheduler = other._scheduler;
+    this->_onTick = other._onTick;
+}
+template <typename Clock>
+HaCTick<Clock> &HaCTick<Clock>::operator=(const HaCTick &other){
+    if(this == &other) return *this;
+    this->stop();
+    this->_duration = other._duration;
+    this->_mode = other._mode;
+    this->_scheduler = other._scheduler;
+    this->_onTick = other._onTick;
+    return *this;
+}
+template <typename Clock>
+HaCTick<Clock>::HaCTick(HaCTick &&other) noexcept{
+    this->_take(other);
+}
+template <typename Clock>
+HaCTick<Clock> &HaCTick<Clock>::operator=(HaCTick &&other) noexcept{
+    if(this == &other) return *this;
+    this->stop();
+    this->_take(other);
+    return *this;
+}
+template <typename Clock>
+HaCTick<Clock>::~HaCTick(){
+    this->stop();
+}
+template <typename Clock>
+void HaCTick<Clock>::begin(){
+    this->_arm(TICK_PERIODIC);
+}
+template <typename Clock>
+void HaCTick<Clock>::beginOnce(){
+    this->_arm(TICK_ONE_SHOT);
+}
+template <typename Clock>
+void HaCTick<Clock>::beginFixedRate(){
+    this->_arm(TICK_FIXED_RATE);
+}
+template <typename Clock>
+void HaCTick<Clock>::stop(){
+    if(this->_heapIndex < 0) return;
+    this->_owner()._remove(this);
+}
+template <typename Clock>
+bool HaCTick<Clock>::isRunning() const{
+    return this->_heapIndex >= 0;
+}
+template <typename Clock>
+TickMode HaCTick<Clock>::getMode() const{
+    return this->_mode;
+}
+template <typename Clock>
+void HaCTick<Clock>::onTick(tListGenCbFnTick fn){
+    this->_onTick = fn;
+}
+template <typename Clock>
+void HaCTick<Clock>::handle(){
+    if(this->_heapIndex < 0) return;
+
+    unsigned long now = Clock::now();
+    if((long)(this->_deadline - now) <= 0) this->_owner()._fire(this, now);
+}
+template <typename Clock>
+void HaCTick<Clock>::_arm(TickMode mode){
+    this->_mode = mode;
+    unsigned long now = Clock::now();
+    // The periodic mode fires once more than the duration elapsed, as the polled timer did
+    unsigned long deadline = now + this->_duration + (mode == TICK_PERIODIC ? 1 : 0);
+    this->_owner()._schedule(this, deadline);
+}
+template <typename Clock>
+HaCTickScheduler<Clock> &HaCTick<Clock>::_owner() const{
+    return this->_scheduler ? *this->_scheduler : HaCTickScheduler<Clock>::instance();
+}
+// Takes the setup and the heap slot of a timer about to be destroyed or reassigned
+template <typename Clock>
+void HaCTick<Clock>::_take(HaCTick &other){
+    this->_duration = other._duration;
+    this->_deadline = other._deadline;
+    this->_mode = other._mode;
+    this->_scheduler = other._scheduler;
+    this->_onTick = std::move(other._onTick);
+    this->_heapIndex = other._heapIndex;
+    other._heapIndex = -1;
+    if(this->_heapIndex >= 0) this->_owner()._relocate(this);
+}
+template <typename Clock>
+unsigned long HaCTick<Clock>::_nextDeadline(unsigned long now) const{
+    if(this->_mode != TICK_FIXED_RATE || this->_duration == 0)
+        return now + this->_duration + 1;
+
+    // Periods missed by a blocked loop are skipped, keeping the phase without a burst
+    unsigned long late = now - this->_deadline;
+    return this->_deadline + (late / this->_duration + 1) * this->_duration;
+}
 /* #endregion */
\ No newline at end of file
@@ -27,32 +27,119 @@
 /* #region EXTERNAL_DEPENDENCY */
 #include <Arduino.h>
 #include <memory>
+#include <vector>
 /* #endregion */
 
 /* #region INTERNAL_DEPENDENCY */
+#include "hacfunction.h"
 
 /* #endregion */
 
 /* #region GLOBAL_VARIABLES */
-typedef std::function<void()> tListGenCbFnTick;
+typedef HaCFunction<void()> tListGenCbFnTick;
+
+#define TICK_NO_DEADLINE ((unsigned long)-1)                            // No timer armed
+
+enum TickMode
+{
+    TICK_PERIODIC,      // Rearmed from the time it fired, once more than the duration elapsed
+    TICK_ONE_SHOT,      // Fires once when the duration elapsed
+    TICK_FIXED_RATE     // Deadlines advance by the duration, no drift from the loop latency
+};
+
+// Time sources of the timers
+struct TickClockMs{
+    static unsigned long now() { return millis(); }
+};
+struct TickClockUs{
+    static unsigned long now() { return micros(); }
+};
 /* #endregion */
 
 
 /* #region CLASS_DECLARATION */
-class Tick{
+template <typename Clock> class HaCTick;
+
+/**
+ * Scheduler of the armed timers of a time source.
+ * Armed timers are kept in a min-heap ordered by deadline, so a loop only has to
+ * check the earliest deadline however many timers exist. Stopped timers cost nothing.
+ * Deadlines are compared on their difference, which keeps the order across the
+ * clock rollover as long as no timer is longer than half the clock range.
+ * Note: A scheduler is not thread safe, its timers are armed, stopped and fired by
+ * one task. Timers use the shared instance unless given their own scheduler.
+ */
+template <typename Clock>
+class HaCTickScheduler{
     public:
-        Tick();
-        Tick(unsigned long durationMs);
-        void begin();
+        HaCTickScheduler(){}
+        HaCTickScheduler(const HaCTickScheduler &) = delete;
+        HaCTickScheduler &operator=(const HaCTickScheduler &) = delete;
+        static HaCTickScheduler &instance();                            // Shared scheduler of the time source
+        ~HaCTickScheduler();
+        void handle();                                                  // Fire every due timer, call on the loop
+        size_t size() const;                                            // Number of armed timers
+        unsigned long timeToNext() const;                               // Time to the earliest deadline, 0 if due
+    private:
+        friend class HaCTick<Clock>;
+        std::vector<HaCTick<Clock> *> _heap;
+
+        void _schedule(HaCTick<Clock> *tick, unsigned long deadline);
+        void _remove(HaCTick<Clock> *tick);
+        void _relocate(HaCTick<Clock> *tick);
+        void _fire(HaCTick<Clock> *tick, unsigned long now);
+        size_t _countDue(size_t index, unsigned long now) const;
+        bool _before(size_t a, size_t b) const;
+        void _swap(size_t a, size_t b);
+        void _siftUp(size_t index);
+        void _siftDown(size_t index);
+};
+
+/**
+ * Timer handle, the duration is in the unit of the time source.
+ * Note: The timer is served by the shared scheduler of its time source once armed,
+ * calling handle on each timer is still supported for code which polls its own timers.
+ * A copy takes the setup but not the armed state, a move takes both, so timers can be
+ * kept in a std::vector.
+ */
+template <typename Clock>
+class HaCTick{
+    public:
+        HaCTick();
+        HaCTick(unsigned long duration);
+        HaCTick(unsigned long duration, HaCTickScheduler<Clock> &scheduler);
+        HaCTick(const HaCTick &other);
+        HaCTick &operator=(const HaCTick &other);
+        HaCTick(HaCTick &&other) noexcept;
+        HaCTick &operator=(HaCTick &&other) noexcept;
+        ~HaCTick();
+        void begin();                                                   // TICK_PERIODIC
+        void beginOnce();                                               // TICK_ONE_SHOT
+        void beginFixedRate();                                          // TICK_FIXED_RATE
         void stop();
+        bool isRunning() const;
+        TickMode getMode() const;
         void onTick(tListGenCbFnTick fn);
         void handle();                                                  // This should be call on the loop
     private:
-        unsigned long _timer = millis();
-        unsigned long _durationMs = 1000;
-        bool _cancel = true;                
+        friend class HaCTickScheduler<Clock>;
+        unsigned long _duration = 1000;
+        unsigned long _deadline = 0;
+        TickMode _mode = TICK_PERIODIC;
+        int32_t _heapIndex = -1;                                        // -1 when not armed
+        HaCTickScheduler<Clock> *_scheduler = nullptr;                  // nullptr for the shared instance
         tListGenCbFnTick _onTick;
+
+        HaCTickScheduler<Clock> &_owner() const;
+        void _arm(TickMode mode);
+        void _take(HaCTick &other);
+        unsigned long _nextDeadline(unsigned long now) const;
 };
+
+typedef HaCTick<TickClockMs> Tick;                                      // Millisecond timer
+typedef HaCTick<TickClockUs> TickUs;                                    // Microsecond timer
+typedef HaCTickScheduler<TickClockMs> TickScheduler;
+typedef HaCTickScheduler<TickClockUs> TickSchedulerUs;
 /* #endregion Common class */
 
 #include "tick-impl.h"
@@ -0,0 +1,117 @@
+/**
+ * Arduino stub of the native unit tests.
+ * Note: Only what the library uses. The clock does not run by itself, the tests move it.
+ */
+#ifndef __HAC_TEST_ARDUINO_H_
+#define __HAC_TEST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+
+#define PROGMEM
+#define IRAM_ATTR
+#define F(string) (reinterpret_cast<const __FlashStringHelper *>(string))
+#define snprintf_P snprintf
+#define strcpy_P strcpy
+
+class __FlashStringHelper;
+typedef bool boolean;
+
+inline unsigned long &hacTestMillis() { static unsigned long ms = 0; return ms; }
+inline unsigned long &hacTestMicros() { static unsigned long us = 0; return us; }
+inline unsigned long &hacTestDelayCalls() { static unsigned long calls = 0; return calls; }
+inline unsigned long millis() { return hacTestMillis(); }
+inline unsigned long micros() { return hacTestMicros(); }
+inline void delay(unsigned long ms)
+{
+    hacTestDelayCalls()++;
+    hacTestMillis() += ms;
+    hacTestMicros() += ms * 1000;
+}
+inline void yield() {}
+inline long random(long howBig) { return howBig ? rand() % howBig : 0; }
+inline long random(long howSmall, long howBig) { return howSmall + random(howBig - howSmall); }
+inline void randomSeed(unsigned long seed) { srand(seed); }
+
+template <class T, class L, class H>
+inline T constrain(T x, L low, H high) { return x < (T)low ? (T)low : (x > (T)high ? (T)high : x); }
+
+class String : public std::string
+{
+public:
+    String() {}
+    String(const char *s) : std::string(s ? s : "") {}
+    String(const std::string &s) : std::string(s) {}
+    String(int v) : std::string(std::to_string(v)) {}
+    String(unsigned int v) : std::string(std::to_string(v)) {}
+    String(long v) : std::string(std::to_string(v)) {}
+    String(unsigned long v) : std::string(std::to_string(v)) {}
+    String(unsigned char v) : std::string(std::to_string(v)) {}
+    String(float v) : std::string(std::to_string(v)) {}
+    String(double v) : std::string(std::to_string(v)) {}
+    unsigned int length() const { return this->size(); }
+    friend String operator+(const String &a, const String &b) { return String((const std::string &)a + (const std::string &)b); }
+    friend String operator+(const String &a, const char *b) { return String((const std::string &)a + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + (const std::string &)b); }
+    bool operator==(const char *other) const { return this->compare(other) == 0; }
+    bool operator!=(const char *other) const { return this->compare(other) != 0; }
+    bool operator==(const String &other) const { return this->compare(other) == 0; }
+    bool operator!=(const String &other) const { return this->compare(other) != 0; }
+};
+
+class IPAddress
+{
+public:
+    IPAddress() {}
+    IPAddress(uint32_t address) : _address(address) {}
+    IPAddress(uint8_t a0, uint8_t a1, uint8_t a2, uint8_t a3)
+        : _address(a0 | (a1 << 8) | (a2 << 16) | ((uint32_t)a3 << 24)) {}
+    bool fromString(const String &s)
+    {
+        unsigned b[4];
+        if (sscanf(s.c_str(), "%u.%u.%u.%u", b, b + 1, b + 2, b + 3) != 4) return false;
+        this->_address = b[0] | (b[1] << 8) | (b[2] << 16) | (b[3] << 24);
+        return true;
+    }
+    String toString() const
+    {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (unsigned)(*this)[0], (unsigned)(*this)[1],
+                 (unsigned)(*this)[2], (unsigned)(*this)[3]);
+        return String(buffer);
+    }
+    operator uint32_t() const { return this->_address; }
+    bool isSet() const { return this->_address != 0; }
+    uint8_t operator[](int index) const { return (this->_address >> (8 * index)) & 255; }
+
+private:
+    uint32_t _address = 0;
+};
+
+struct HardwareSerial
+{
+    void begin(long) {}
+    template <class... Args>
+    void printf(const char *format, Args... args) { ::printf(format, args...); }
+    void println(const String &s) { puts(s.c_str()); }
+};
+inline HardwareSerial Serial;
+
+struct EspClass
+{
+    uint32_t getMaxFreeBlockSize() { return 40000; }
+    uint32_t getFreeHeap() { return 40000; }
+    uint32_t getChipId() { return 0x1234; }
+};
+inline EspClass ESP;
+
+using std::max;
+using std::min;
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * ArduinoJson stub of the native unit tests.
+ * Note: Documents are always empty, the tests set the parameters through the API.
+ */
+#ifndef __HAC_TEST_ARDUINOJSON_H_
+#define __HAC_TEST_ARDUINOJSON_H_
+
+#include <Arduino.h>
+
+struct JsonObject;
+
+struct JsonVariant
+{
+    template <class K>
+    JsonVariant operator[](K) const { return JsonVariant(); }
+    template <class T>
+    JsonVariant &operator=(const T &) { return *this; }
+    template <class T>
+    T as() const { return T(); }
+    template <class T>
+    bool is() const { return false; }
+    template <class T>
+    operator T() const { return T(); }
+    template <class T>
+    bool add(const T &) const { return true; }
+    template <class K>
+    bool containsKey(K) const { return false; }
+    bool isNull() const { return true; }
+    JsonObject createNestedObject(const char *) const;
+};
+
+struct JsonPair
+{
+    JsonVariant value() const { return JsonVariant(); }
+    const char *key() const { return ""; }
+};
+
+struct JsonObject : JsonVariant
+{
+    JsonPair *begin() { return nullptr; }
+    JsonPair *end() { return nullptr; }
+};
+
+inline JsonObject JsonVariant::createNestedObject(const char *) const { return JsonObject(); }
+template <>
+inline JsonObject JsonVariant::as<JsonObject>() const { return JsonObject(); }
+
+struct DeserializationError
+{
+    operator bool() const { return false; }
+    const char *c_str() const { return ""; }
+};
+
+struct DynamicJsonDocument : JsonVariant
+{
+    DynamicJsonDocument(size_t) {}
+    void shrinkToFit() {}
+    void clear() {}
+};
+
+template <class Document, class Source>
+DeserializationError deserializeJson(Document &, Source) { return DeserializationError(); }
+template <class Document>
+size_t serializeJson(const Document &, char *, size_t) { return 0; }
+template <class Document>
+size_t serializeJson(const Document &, String &) { return 0; }
+
+#endif
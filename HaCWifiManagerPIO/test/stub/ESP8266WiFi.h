@@ -0,0 +1,228 @@
+/**
+ * ESP8266 WiFi stub of the native unit tests.
+ * Note: Nothing happens by itself, the tests complete the scans and raise the station events.
+ */
+#ifndef __HAC_TEST_ESP8266WIFI_H_
+#define __HAC_TEST_ESP8266WIFI_H_
+
+#include <Arduino.h>
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_WRONG_PASSWORD = 6,
+    WL_DISCONNECTED = 7
+} wl_status_t;
+
+enum WiFiMode_t
+{
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+};
+enum WiFiSleepType
+{
+    WIFI_NONE_SLEEP = 0,
+    WIFI_LIGHT_SLEEP = 1,
+    WIFI_MODEM_SLEEP = 2
+};
+enum WiFiPhyMode
+{
+    WIFI_PHY_MODE_11B = 1,
+    WIFI_PHY_MODE_11G = 2,
+    WIFI_PHY_MODE_11N = 3
+};
+enum WiFiDisconnectReason
+{
+    WIFI_DISCONNECT_REASON_UNSPECIFIED = 1,
+    WIFI_DISCONNECT_REASON_AUTH_EXPIRE = 2,
+    WIFI_DISCONNECT_REASON_AUTH_LEAVE = 3,
+    WIFI_DISCONNECT_REASON_ASSOC_EXPIRE = 4,
+    WIFI_DISCONNECT_REASON_4WAY_HANDSHAKE_TIMEOUT = 15,
+    WIFI_DISCONNECT_REASON_BEACON_TIMEOUT = 200,
+    WIFI_DISCONNECT_REASON_NO_AP_FOUND = 201,
+    WIFI_DISCONNECT_REASON_AUTH_FAIL = 202,
+    WIFI_DISCONNECT_REASON_ASSOC_FAIL = 203,
+    WIFI_DISCONNECT_REASON_HANDSHAKE_TIMEOUT = 204
+};
+
+#define STATION_IF 0
+#define SOFTAP_IF 1
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+struct ip_addr
+{
+    uint32_t addr;
+};
+struct ip_info
+{
+    struct ip_addr ip;
+    struct ip_addr netmask;
+    struct ip_addr gw;
+};
+inline bool wifi_get_ip_info(int, struct ip_info *info)
+{
+    *info = ip_info();
+    return true;
+}
+inline bool wifi_station_dhcpc_stop() { return true; }
+inline bool wifi_station_dhcpc_start() { return true; }
+
+struct WiFiEventStationModeConnected
+{
+    String ssid;
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+struct WiFiEventStationModeDisconnected
+{
+    String ssid;
+    uint8_t bssid[6];
+    WiFiDisconnectReason reason;
+};
+struct WiFiEventHandlerOpaque
+{
+};
+typedef std::shared_ptr<WiFiEventHandlerOpaque> WiFiEventHandler;
+
+class ESP8266WiFiClass
+{
+public:
+    /* #region Test */
+    wl_status_t stationStatus = WL_DISCONNECTED;
+    int8_t scanResult = WIFI_SCAN_RUNNING;   // Returned by scanComplete
+    String scanSsid = "ssid";                // SSID of every scan result
+    unsigned long scanItemUs = 0;            // Clock advance of collecting one scan result
+    unsigned long beginCalls = 0;
+    unsigned long softAPCalls = 0;
+    unsigned long scanCalls = 0;
+    std::function<void(int)> scanDone;
+    std::function<void(const WiFiEventStationModeConnected &)> stationConnected;
+    std::function<void(const WiFiEventStationModeDisconnected &)> stationDisconnected;
+
+    // Finish the running asynchronous scan with the given number of networks
+    void completeScan(int8_t networks)
+    {
+        this->scanResult = networks;
+        if (this->scanDone) this->scanDone(networks);
+    }
+    // Associate the station to the last network given to begin
+    void associate()
+    {
+        WiFiEventStationModeConnected event = WiFiEventStationModeConnected();
+        event.ssid = this->_ssid;
+        event.channel = 1;
+        this->stationStatus = WL_CONNECTED;
+        if (this->stationConnected) this->stationConnected(event);
+    }
+    /* #endregion */
+
+    wl_status_t status() { return this->stationStatus; }
+    wl_status_t begin(const char *ssid, const char * = nullptr, int32_t = 0, const uint8_t * = nullptr, bool = true)
+    {
+        this->_ssid = ssid;
+        this->beginCalls++;
+        return this->stationStatus;
+    }
+    bool reconnect() { return true; }
+    bool disconnect(bool = false)
+    {
+        this->stationStatus = WL_DISCONNECTED;
+        return true;
+    }
+    bool config(IPAddress, IPAddress, IPAddress, IPAddress = IPAddress(), IPAddress = IPAddress()) { return true; }
+    bool mode(WiFiMode_t mode)
+    {
+        this->_mode = mode;
+        return true;
+    }
+    WiFiMode_t getMode() { return this->_mode; }
+    void persistent(bool) {}
+    bool setAutoReconnect(bool) { return true; }
+    bool setSleepMode(WiFiSleepType) { return true; }
+    bool setPhyMode(WiFiPhyMode) { return true; }
+    void setOutputPower(float) {}
+    bool forceSleepBegin() { return true; }
+    bool forceSleepWake() { return true; }
+    bool hostname(const char *) { return true; }
+
+    String SSID() { return this->_ssid; }
+    String SSID(uint8_t) { return this->scanSsid; }
+    int32_t RSSI() { return -60; }
+    int32_t RSSI(uint8_t) { return -60; }
+    int32_t channel() { return 1; }
+    int32_t channel(uint8_t) { return 1; }
+    uint8_t *BSSID() { return this->_bssid; }
+    uint8_t *BSSID(uint8_t) { return this->_bssid; }
+    String BSSIDstr() { return "00:00:00:00:00:00"; }
+    uint8_t *macAddress(uint8_t *mac)
+    {
+        memset(mac, 1, 6);
+        return mac;
+    }
+    IPAddress localIP() { return IPAddress(); }
+    IPAddress subnetMask() { return IPAddress(); }
+    IPAddress gatewayIP() { return IPAddress(); }
+    IPAddress dnsIP(uint8_t = 0) { return IPAddress(); }
+
+    String softAPSSID() { return "ap"; }
+    bool softAP(const char *, const char *, int = 1, int = 0, int = 4)
+    {
+        this->softAPCalls++;
+        return true;
+    }
+    bool softAPConfig(IPAddress, IPAddress, IPAddress) { return true; }
+    bool softAPdisconnect(bool = false) { return true; }
+    uint8_t softAPgetStationNum() { return 0; }
+
+    int8_t scanNetworks(bool = false, bool = false, uint8_t = 0, uint8_t * = nullptr) { return WIFI_SCAN_FAILED; }
+    void scanNetworksAsync(std::function<void(int)> onComplete, bool = false)
+    {
+        this->scanDone = onComplete;
+        this->scanResult = WIFI_SCAN_RUNNING;
+        this->scanCalls++;
+    }
+    int8_t scanComplete() { return this->scanResult; }
+    void scanDelete() { this->scanResult = WIFI_SCAN_FAILED; }
+    bool getNetworkInfo(uint8_t index, String &ssid, uint8_t &encryption, int32_t &rssi, uint8_t *&bssid,
+                        int32_t &channel, bool &hidden)
+    {
+        hacTestMicros() += this->scanItemUs;
+        ssid = this->scanSsid;
+        encryption = 0;
+        rssi = -50;
+        // Every result is another access point than the associated one
+        this->_scanBssid[5] = index + 1;
+        bssid = this->_scanBssid;
+        channel = 1;
+        hidden = false;
+        return true;
+    }
+
+    WiFiEventHandler onStationModeConnected(std::function<void(const WiFiEventStationModeConnected &)> fn)
+    {
+        this->stationConnected = fn;
+        return WiFiEventHandler();
+    }
+    WiFiEventHandler onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected &)> fn)
+    {
+        this->stationDisconnected = fn;
+        return WiFiEventHandler();
+    }
+
+private:
+    String _ssid;
+    WiFiMode_t _mode = WIFI_OFF;
+    uint8_t _bssid[6] = {0, 0, 0, 0, 0, 0};
+    uint8_t _scanBssid[6] = {2, 0, 0, 0, 0, 0};
+};
+inline ESP8266WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,17 @@
+/**
+ * ESP8266 mDNS stub of the native unit tests.
+ */
+#ifndef __HAC_TEST_ESP8266MDNS_H_
+#define __HAC_TEST_ESP8266MDNS_H_
+
+#include <Arduino.h>
+
+struct MDNSResponder
+{
+    bool begin(const char *) { return true; }
+    void update() {}
+    void end() {}
+};
+inline MDNSResponder MDNS;
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ * LittleFS stub of the native unit tests.
+ * Note: Nothing is stored, every file is missing.
+ */
+#ifndef __HAC_TEST_LITTLEFS_H_
+#define __HAC_TEST_LITTLEFS_H_
+
+#include <Arduino.h>
+
+struct File
+{
+    operator bool() const { return false; }
+    int available() { return 0; }
+    int read() { return -1; }
+    size_t print(const char *) { return 0; }
+    size_t write(const uint8_t *, size_t size) { return size; }
+    void close() {}
+};
+
+struct FS
+{
+    bool begin() { return true; }
+    void end() {}
+    File open(const char *, const char *) { return File(); }
+    bool exists(const char *) { return false; }
+    bool remove(const char *) { return true; }
+};
+inline FS LittleFS;
+
+#endif
@@ -0,0 +1,19 @@
+/**
+ * lwIP DHCP stub of the native unit tests.
+ */
+#ifndef __HAC_TEST_LWIP_DHCP_H_
+#define __HAC_TEST_LWIP_DHCP_H_
+
+#include "etharp.h"
+
+struct dhcp
+{
+    uint32_t offered_t0_lease;
+};
+
+inline struct dhcp *netif_dhcp_data(struct netif *) { static struct dhcp data = {0}; return &data; }
+inline uint8_t dhcp_supplied_address(const struct netif *) { return 0; }
+inline err_t dhcp_start(struct netif *) { return ERR_OK; }
+inline void dhcp_stop(struct netif *) {}
+
+#endif
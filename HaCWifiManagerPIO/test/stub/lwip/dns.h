@@ -0,0 +1,11 @@
+/**
+ * lwIP DNS stub of the native unit tests.
+ */
+#ifndef __HAC_TEST_LWIP_DNS_H_
+#define __HAC_TEST_LWIP_DNS_H_
+
+#include "etharp.h"
+
+inline const ip_addr_t *dns_getserver(uint8_t) { static ip_addr_t server = {0}; return &server; }
+
+#endif
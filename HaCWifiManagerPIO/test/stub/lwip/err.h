@@ -0,0 +1,10 @@
+/**
+ * lwIP error stub of the native unit tests.
+ */
+#ifndef __HAC_TEST_LWIP_ERR_H_
+#define __HAC_TEST_LWIP_ERR_H_
+
+typedef signed char err_t;
+#define ERR_OK 0
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * lwIP ARP stub of the native unit tests.
+ * Note: The ARP table is empty, there is no station interface.
+ */
+#ifndef __HAC_TEST_LWIP_ETHARP_H_
+#define __HAC_TEST_LWIP_ETHARP_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "err.h"
+
+typedef struct
+{
+    uint32_t addr;
+} ip4_addr_t;
+typedef ip4_addr_t ip_addr_t;
+
+struct netif
+{
+    struct netif *next;
+    ip4_addr_t ip_addr;
+    bool up;
+};
+struct eth_addr
+{
+    uint8_t addr[6];
+};
+
+inline struct netif *netif_list = nullptr;
+#define netif_is_up(netif) ((netif)->up)
+#define netif_ip4_addr(netif) (&(netif)->ip_addr)
+#define ip4_addr_get_u32(ip) ((ip)->addr)
+#define ip4_addr_set_u32(ip, value) ((ip)->addr = (value))
+
+inline err_t etharp_request(struct netif *, const ip4_addr_t *) { return ERR_OK; }
+inline err_t etharp_query(struct netif *, const ip4_addr_t *, void *) { return ERR_OK; }
+inline ssize_t etharp_find_addr(struct netif *, const ip4_addr_t *, struct eth_addr **, const ip4_addr_t **) { return -1; }
+
+#endif
@@ -0,0 +1,180 @@
+/**
+ *
+ * @file test_backoff_fleet/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <unity.h>
+#include <stdio.h>
+#include <set>
+#include <vector>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "backoff.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+#define FLEET_SIZE 100
+#define OUTAGE_MS 300000UL          // The access point is down for 5 minutes
+#define WINDOW_MS 200               // Reconnect burst window seen by the access point
+#define FIRST_SPREAD (2 * BACKOFF_BASE) // The first retry is spread over base to three times base
+#define EVEN_PEAK (FLEET_SIZE * WINDOW_MS / FIRST_SPREAD) // Attempts per window of an evenly spread first retry
+
+/**
+ * Fleet of devices with consecutive mac addresses, as shipped from one batch.
+ */
+static std::vector<HaCBackoff> makeFleet()
+{
+    std::vector<HaCBackoff> fleet(FLEET_SIZE);
+    for (uint8_t i = 0; i < FLEET_SIZE; i++)
+    {
+        uint8_t mac[6] = {0x24, 0x0A, 0xC4, 0x12, 0x34, i};
+        fleet[i].seed(mac);
+    }
+    return fleet;
+}
+
+/**
+ * Simulate the outage, every device retries at its backoff delays.
+ * @param fromMs Ignore the attempts before this time
+ * @param outOfBounds Delays outside base and cap
+ * @return Largest number of attempts within one window
+ */
+static uint16_t peakAttempts(std::vector<HaCBackoff> &fleet, unsigned long fromMs, uint32_t &outOfBounds)
+{
+    outOfBounds = 0;
+    std::vector<uint16_t> windows(OUTAGE_MS / WINDOW_MS + 1, 0);
+    for (HaCBackoff &device : fleet)
+    {
+        unsigned long t = 0;
+        while (true)
+        {
+            unsigned long delay = device.next();
+            if (delay < BACKOFF_BASE || delay > BACKOFF_CAP) outOfBounds++;
+            t += delay;
+            if (t > OUTAGE_MS) break;
+            windows[t / WINDOW_MS]++;
+        }
+    }
+    uint16_t peak = 0;
+    for (size_t i = fromMs / WINDOW_MS; i < windows.size(); i++) peak = max(peak, windows[i]);
+    return peak;
+}
+/* #endregion */
+
+void setUp() {}
+void tearDown() {}
+
+// Consecutive mac addresses give distinct schedules
+void test_fleet_is_decorrelated()
+{
+    std::vector<HaCBackoff> fleet = makeFleet();
+    std::set<unsigned long> first, second;
+    for (HaCBackoff &device : fleet)
+    {
+        first.insert(device.next());
+        second.insert(device.next());
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(FLEET_SIZE * 9 / 10, first.size());
+    TEST_ASSERT_GREATER_OR_EQUAL(FLEET_SIZE * 9 / 10, second.size());
+}
+
+// The access point never sees the fleet retrying in lockstep
+void test_fleet_reconnect_burst()
+{
+    const unsigned long from[] = {0, 10000, 60000};
+    uint16_t peaks[3];
+    uint32_t outOfBounds;
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        std::vector<HaCBackoff> fleet = makeFleet();
+        peaks[i] = peakAttempts(fleet, from[i], outOfBounds);
+        TEST_ASSERT_EQUAL(0, outOfBounds);
+        char msg[64];
+        snprintf(msg, sizeof(msg), "peak %u attempts per %u ms after %lu ms", peaks[i], WINDOW_MS, from[i]);
+        TEST_MESSAGE(msg);
+    }
+    // The first retry is close to evenly spread
+    TEST_ASSERT_LESS_OR_EQUAL(2 * EVEN_PEAK, peaks[0]);
+    // Then the fleet spreads further with every attempt
+    TEST_ASSERT_LESS_OR_EQUAL(EVEN_PEAK, peaks[1]);
+    TEST_ASSERT_LESS_OR_EQUAL(EVEN_PEAK * 3 / 4, peaks[2]);
+
+    // Same fleet without seeding is in lockstep
+    std::vector<HaCBackoff> unseeded(FLEET_SIZE);
+    TEST_ASSERT_EQUAL(FLEET_SIZE, peakAttempts(unseeded, 0, outOfBounds));
+}
+
+// Delays grow towards the cap and restart from the base after a connection
+void test_backoff_growth_and_reset()
+{
+    HaCBackoff backoff;
+    backoff.seed(0xC0FFEE);
+    unsigned long total = 0;
+    for (uint8_t i = 0; i < 20; i++) total += backoff.next();
+    TEST_ASSERT_EQUAL(20, backoff.attempts());
+    // Mean delay well above the base once grown
+    TEST_ASSERT_GREATER_THAN(20UL * BACKOFF_BASE * 5, total);
+
+    backoff.reset();
+    TEST_ASSERT_EQUAL(0, backoff.attempts());
+    TEST_ASSERT_LESS_OR_EQUAL(3 * BACKOFF_BASE, backoff.next());
+}
+
+// A cap below the base is raised to the base
+void test_backoff_degenerate_bounds()
+{
+    HaCBackoff backoff(5000, 100);
+    for (uint8_t i = 0; i < 10; i++) TEST_ASSERT_EQUAL(5000, backoff.next());
+}
+
+// A fleet dropped by a rebooting access point spreads its first same access point retry
+void test_first_retry_jitter()
+{
+    std::vector<HaCBackoff> fleet = makeFleet();
+    const uint8_t slots = 10;
+    uint16_t windows[slots] = {0};
+    for (HaCBackoff &device : fleet)
+    {
+        unsigned long delay = device.jitter();
+        TEST_ASSERT_LESS_THAN(BACKOFF_FIRST_JITTER, delay);
+        TEST_ASSERT_EQUAL(1, device.attempts());
+        windows[delay * slots / BACKOFF_FIRST_JITTER]++;
+        // Later retries follow the backoff from the base
+        unsigned long next = device.next();
+        TEST_ASSERT_GREATER_OR_EQUAL(BACKOFF_BASE, next);
+        TEST_ASSERT_LESS_OR_EQUAL(3 * BACKOFF_BASE, next);
+    }
+    for (uint8_t i = 0; i < slots; i++) TEST_ASSERT_LESS_OR_EQUAL(2 * FLEET_SIZE / slots, windows[i]);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fleet_is_decorrelated);
+    RUN_TEST(test_fleet_reconnect_burst);
+    RUN_TEST(test_backoff_growth_and_reset);
+    RUN_TEST(test_backoff_degenerate_bounds);
+    RUN_TEST(test_first_retry_jitter);
+    return UNITY_END();
+}
@@ -0,0 +1,143 @@
+/**
+ *
+ * @file test_connect_estimator/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <unity.h>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "networkstats.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+#define FLOOR 2000
+#define CEILING 15000
+#define K 3.0f
+/* #endregion */
+
+void setUp() {}
+void tearDown() {}
+
+// The ceiling is used until the estimator has enough samples
+void test_cold_estimator_uses_ceiling()
+{
+    HaCConnectEstimator estimator;
+    TEST_ASSERT_EQUAL(CEILING, estimator.deadline(K, FLOOR, CEILING));
+    for (uint8_t i = 1; i < CONNECT_ESTIMATOR_MIN_SAMPLES; i++)
+    {
+        estimator.addSample(3000);
+        TEST_ASSERT_EQUAL(CEILING, estimator.deadline(K, FLOOR, CEILING));
+    }
+    estimator.addSample(3000);
+    TEST_ASSERT_EQUAL(3000, estimator.deadline(K, FLOOR, CEILING));
+}
+
+// The first samples give the plain mean and variance
+void test_cumulative_mean_and_variance()
+{
+    HaCConnectEstimator estimator;
+    estimator.addSample(2000);
+    estimator.addSample(4000);
+    estimator.addSample(6000);
+    TEST_ASSERT_EQUAL(3, estimator.count());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 4000.0f, estimator.mean());
+    // Population variance of {2000, 4000, 6000}
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, sqrtf(8000000.0f / 3.0f), estimator.stddev());
+    TEST_ASSERT_EQUAL((unsigned long)(estimator.mean() + K * estimator.stddev()),
+                      estimator.deadline(K, FLOOR, CEILING));
+}
+
+// The deadline stays within floor and ceiling
+void test_deadline_is_bounded()
+{
+    HaCConnectEstimator fast;
+    for (uint8_t i = 0; i < 10; i++) fast.addSample(300);
+    TEST_ASSERT_EQUAL(FLOOR, fast.deadline(K, FLOOR, CEILING));
+
+    HaCConnectEstimator slow;
+    for (uint8_t i = 0; i < 10; i++) slow.addSample(i % 2 ? 9000 : 14000);
+    TEST_ASSERT_EQUAL(CEILING, slow.deadline(K, FLOOR, CEILING));
+}
+
+// Once warm the estimator follows a network whose time to IP changed
+void test_estimator_adapts()
+{
+    HaCConnectEstimator estimator;
+    for (uint8_t i = 0; i < 50; i++) estimator.addSample(2500);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 2500.0f, estimator.mean());
+
+    uint8_t samples = 0;
+    while (estimator.mean() < 7500.0f && samples < 50)
+    {
+        estimator.addSample(8000);
+        samples++;
+    }
+    // Weight 0.25 per sample, 90% of the step within 9 samples
+    TEST_ASSERT_LESS_OR_EQUAL(9, samples);
+    TEST_ASSERT_GREATER_THAN(2500, estimator.deadline(K, FLOOR, CEILING));
+}
+
+// A single slow attempt widens the deadline without moving it to the ceiling
+void test_outlier_is_damped()
+{
+    HaCConnectEstimator estimator;
+    for (uint8_t i = 0; i < 20; i++) estimator.addSample(3000 + (i % 3) * 100);
+    unsigned long before = estimator.deadline(K, FLOOR, CEILING);
+    estimator.addSample(6000);
+    unsigned long after = estimator.deadline(K, FLOOR, CEILING);
+    TEST_ASSERT_GREATER_THAN(before, after);
+    TEST_ASSERT_LESS_THAN(CEILING, after);
+}
+
+// The sample count saturates instead of wrapping to a cold estimator
+void test_count_saturates()
+{
+    HaCConnectEstimator estimator;
+    for (uint32_t i = 0; i < 70000; i++) estimator.addSample(4000);
+    TEST_ASSERT_EQUAL(0xFFFF, estimator.count());
+    TEST_ASSERT_EQUAL(4000, estimator.deadline(K, FLOOR, CEILING));
+}
+
+void test_reset()
+{
+    HaCConnectEstimator estimator;
+    for (uint8_t i = 0; i < 5; i++) estimator.addSample(5000);
+    estimator.reset();
+    TEST_ASSERT_EQUAL(0, estimator.count());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, estimator.mean());
+    TEST_ASSERT_EQUAL(CEILING, estimator.deadline(K, FLOOR, CEILING));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_cold_estimator_uses_ceiling);
+    RUN_TEST(test_cumulative_mean_and_variance);
+    RUN_TEST(test_deadline_is_bounded);
+    RUN_TEST(test_estimator_adapts);
+    RUN_TEST(test_outlier_is_damped);
+    RUN_TEST(test_count_saturates);
+    RUN_TEST(test_reset);
+    return UNITY_END();
+}
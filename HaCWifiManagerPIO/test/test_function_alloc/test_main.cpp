@@ -0,0 +1,100 @@
+/**
+ *
+ * @file test_function_alloc/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "tick.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+#define CYCLES 10000
+
+static unsigned long allocations = 0;
+static unsigned long releases = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (!ptr) return;
+    releases++;
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+typedef HaCFunction<void()> Callback;
+/* #endregion */
+
+void setUp()
+{
+    hacTestMillis() = 0;
+}
+
+void tearDown() {}
+
+// Callbacks capturing a few pointers stay inline through the whole timer life cycle
+void test_inline_callbacks_never_allocate()
+{
+    unsigned long count = 0;
+    unsigned long *counter = &count;
+    Tick timer(10);
+    timer.onTick([counter]() { (*counter)++; });
+    timer.begin();
+
+    unsigned long before = allocations;
+    for (uint32_t i = 0; i < CYCLES; i++)
+    {
+        Callback fn = [counter, i]() { *counter += i & 1; };
+        Callback copy = fn;
+        Callback moved = std::move(copy);
+        timer.onTick(moved);
+        hacTestMillis() += 11;
+        TickScheduler::instance().handle();
+    }
+    TEST_ASSERT_EQUAL(0, allocations - before);
+    TEST_ASSERT_EQUAL(CYCLES / 2, count);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_inline_callbacks_never_allocate);
+    return UNITY_END();
+}
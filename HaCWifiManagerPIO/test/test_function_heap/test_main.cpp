@@ -0,0 +1,172 @@
+/**
+ *
+ * @file test_function_heap/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+#include <thread>
+/* #endregion */
+
+// Larger callbacks go to the heap instead of failing to compile
+#define HAC_FUNCTION_HEAP
+
+/* #region INTERNAL_DEPENDENCY */
+#include "tick.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+#define CYCLES 10000
+
+static std::atomic<unsigned long> allocations{0};
+static std::atomic<unsigned long> releases{0};
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (!ptr) return;
+    releases++;
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+// Larger than the default capacity of four pointers
+struct BigState
+{
+    unsigned long values[8];
+};
+
+typedef HaCFunction<void()> Callback;
+/* #endregion */
+
+void setUp()
+{
+    hacTestMillis() = 0;
+}
+
+void tearDown() {}
+
+// A large callback allocates once, copies and moves share it
+void test_heap_callbacks_allocate_once()
+{
+    BigState state = {};
+    unsigned long count = 0;
+    unsigned long *counter = &count;
+    Tick timer(10);
+    timer.begin();
+
+    unsigned long before = allocations, freed = releases;
+    for (uint32_t i = 0; i < CYCLES; i++)
+    {
+        state.values[0] = i;
+        Callback fn = [state, counter]() { *counter += state.values[0] & 1; };
+        Callback copy = fn;
+        Callback moved = std::move(copy);
+        timer.onTick(moved);
+        hacTestMillis() += 11;
+        TickScheduler::instance().handle();
+    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%lu allocations over %u cycles", allocations - before, CYCLES);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL(CYCLES, allocations - before);
+    TEST_ASSERT_EQUAL(CYCLES / 2, count);
+
+    timer.onTick(nullptr);
+    TEST_ASSERT_EQUAL(allocations - before, releases - freed);
+}
+
+// A heap stored callback is released with its last copy
+void test_heap_callback_lifetime()
+{
+    BigState state = {};
+    state.values[7] = 42;
+    unsigned long before = allocations, freed = releases;
+    {
+        Callback fn = [state]() { (void)state; };
+        {
+            Callback copy = fn;
+            Callback other;
+            other = copy;
+            other = nullptr;
+            TEST_ASSERT_TRUE((bool)copy);
+        }
+        TEST_ASSERT_EQUAL(0, releases - freed);
+        Callback moved = std::move(fn);
+        TEST_ASSERT_FALSE((bool)fn);
+        TEST_ASSERT_TRUE((bool)moved);
+    }
+    TEST_ASSERT_EQUAL(1, allocations - before);
+    TEST_ASSERT_EQUAL(1, releases - freed);
+}
+
+// Copies shared between two tasks release the callback exactly once
+void test_heap_callback_shared_across_threads()
+{
+    BigState state = {};
+    state.values[7] = 42;
+    std::atomic<unsigned long> calls{0};
+    unsigned long before = allocations, freed = releases;
+    {
+        Callback fn = [state, &calls]() { calls += state.values[7] == 42; };
+        TEST_ASSERT_EQUAL(1, allocations - before);
+        auto worker = [&fn]() {
+            for (uint32_t i = 0; i < CYCLES * 10; i++)
+            {
+                Callback copy = fn;
+                Callback moved = std::move(copy);
+                moved();
+            }
+        };
+        std::thread first(worker);
+        std::thread second(worker);
+        first.join();
+        second.join();
+        TEST_ASSERT_EQUAL(CYCLES * 20, calls);
+    }
+    // The thread states are allocated too, everything is released once
+    TEST_ASSERT_EQUAL(allocations - before, releases - freed);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_heap_callbacks_allocate_once);
+    RUN_TEST(test_heap_callback_lifetime);
+    RUN_TEST(test_heap_callback_shared_across_threads);
+    return UNITY_END();
+}
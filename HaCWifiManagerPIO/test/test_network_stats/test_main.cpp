@@ -0,0 +1,165 @@
+/**
+ *
+ * @file test_network_stats/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <unity.h>
+#include <stdio.h>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "networkstats.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+/**
+ * Fill the table with net0..netN, one millisecond apart.
+ */
+static void fill(HaCNetworkStatsTable &table)
+{
+    char ssid[8];
+    for (uint8_t i = 0; i < MAX_NETWORK_STATS; i++)
+    {
+        snprintf(ssid, sizeof(ssid), "net%u", i);
+        table.get(ssid);
+        hacTestMillis() += 1;
+    }
+}
+
+static void quarantine(HaCNetworkStatsTable &table, const char *ssid, unsigned long periodMs)
+{
+    t_networkStats *stats = table.get(ssid, false);
+    stats->quarantined = true;
+    stats->quarantineUntil = millis() + periodMs;
+}
+/* #endregion */
+
+void setUp()
+{
+    hacTestMillis() = 1000;
+}
+
+void tearDown() {}
+
+void test_least_recently_used_is_replaced()
+{
+    HaCNetworkStatsTable table;
+    fill(table);
+    table.get("net0");                  // net1 becomes the oldest
+    hacTestMillis() += 1;
+    table.get("new");
+    TEST_ASSERT_NULL(table.get("net1", false));
+    TEST_ASSERT_NOT_NULL(table.get("net0", false));
+    TEST_ASSERT_NOT_NULL(table.get("new", false));
+}
+
+// Replacing a quarantined network would lift its quarantine
+void test_quarantined_is_kept()
+{
+    HaCNetworkStatsTable table;
+    fill(table);
+    quarantine(table, "net0", QUARANTINE_BASE);
+    hacTestMillis() += 1;
+    for (uint8_t i = 1; i < MAX_NETWORK_STATS; i++) table.get(i % 2 ? "net1" : "net2");
+    table.get("new");
+
+    t_networkStats *stats = table.get("net0", false);
+    TEST_ASSERT_NOT_NULL(stats);
+    TEST_ASSERT_TRUE(stats->quarantined);
+    TEST_ASSERT_NULL(table.get("net3", false));
+}
+
+// A released quarantine no longer protects the network
+void test_released_quarantine_is_replaced()
+{
+    HaCNetworkStatsTable table;
+    fill(table);
+    quarantine(table, "net0", 100);
+    hacTestMillis() += 200;
+    for (uint8_t i = 1; i < MAX_NETWORK_STATS; i++)
+    {
+        char ssid[8];
+        snprintf(ssid, sizeof(ssid), "net%u", i);
+        table.get(ssid);
+    }
+    table.get("new");
+    TEST_ASSERT_NULL(table.get("net0", false));
+}
+
+// All quarantined, the earliest released gives way
+void test_all_quarantined()
+{
+    HaCNetworkStatsTable table;
+    fill(table);
+    char ssid[8];
+    for (uint8_t i = 0; i < MAX_NETWORK_STATS; i++)
+    {
+        snprintf(ssid, sizeof(ssid), "net%u", i);
+        quarantine(table, ssid, i == 3 ? 1000 : 5000);
+    }
+    table.get("new");
+    TEST_ASSERT_NULL(table.get("net3", false));
+    TEST_ASSERT_NOT_NULL(table.get("net0", false));
+}
+
+// Quarantine and least recently used survive the millis() rollover
+void test_eviction_across_rollover()
+{
+    hacTestMillis() = (unsigned long)-3;
+    HaCNetworkStatsTable table;
+    fill(table);                        // net0..net2 before, net3..net5 after the rollover
+    quarantine(table, "net0", QUARANTINE_BASE);
+    hacTestMillis() += 10;
+    table.get("new");
+    TEST_ASSERT_NOT_NULL(table.get("net0", false));
+    TEST_ASSERT_NULL(table.get("net1", false));
+    TEST_ASSERT_NOT_NULL(table.get("net5", false));
+
+    t_networkStats *stats = table.get("net0", false);
+    TEST_ASSERT_TRUE((long)(millis() - stats->quarantineUntil) < 0);
+    hacTestMillis() += QUARANTINE_BASE;
+    TEST_ASSERT_TRUE((long)(millis() - stats->quarantineUntil) >= 0);
+}
+
+void test_remove_and_clear()
+{
+    HaCNetworkStatsTable table;
+    fill(table);
+    table.remove("net2");
+    TEST_ASSERT_NULL(table.get("net2", false));
+    TEST_ASSERT_NOT_NULL(table.get("net5", false));
+    table.clear();
+    TEST_ASSERT_NULL(table.get("net5", false));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_least_recently_used_is_replaced);
+    RUN_TEST(test_quarantined_is_kept);
+    RUN_TEST(test_released_quarantine_is_replaced);
+    RUN_TEST(test_all_quarantined);
+    RUN_TEST(test_eviction_across_rollover);
+    RUN_TEST(test_remove_and_clear);
+    return UNITY_END();
+}
@@ -0,0 +1,234 @@
+/**
+ *
+ * @file test_scan_flow/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#define ESP8266
+#include <unity.h>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "HaCWifiManager.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+#define LOOP_PERIOD 10              // Simulated application loop period
+#define SCAN_RESULTS 4
+#define BG_SCAN_INTERVAL 5000
+#define RUN_LIMIT 30000
+
+static const unsigned long scanDurations[] = {35, 120, 480, 730, 1450, 2990};
+
+/**
+ * Completion latency of the former scan polling, scanComplete() was read every WIFI_SCAN_TIMEOUT.
+ * @param scanMs Scan duration
+ * @return Time from the end of the scan until the poll saw it
+ */
+static unsigned long pollingLatency(unsigned long scanMs)
+{
+    return (scanMs / WIFI_SCAN_TIMEOUT + 1) * WIFI_SCAN_TIMEOUT - scanMs;
+}
+
+/**
+ * Move the clock by one loop period.
+ */
+static void tick()
+{
+    hacTestMillis() += LOOP_PERIOD;
+    hacTestMicros() += LOOP_PERIOD * 1000;
+}
+
+/**
+ * Move the clock by one loop period and run a loop pass.
+ */
+static void loopPass(HaCWifiManager &manager)
+{
+    tick();
+    manager.loop();
+}
+
+/**
+ * Start a multi wifi station, the startup scan is running once it returns.
+ */
+static void setupManager(HaCWifiManager &manager)
+{
+    manager.setMode(STA_ONLY);
+    manager.setEnableMultiWifi(true);
+    manager.addWifiList("ssid", "pass");
+    manager.addWifiList("other", "pass");
+    manager.setBackgroundScan(true, BG_SCAN_INTERVAL);
+    manager.setup();
+}
+
+/**
+ * Finish the scan after scanMs and loop until the manager handled it.
+ * @param event Raise the scan done event, else only scanComplete() reports the result
+ * @param handled Manager handled the scan result
+ * @return Time from the end of the scan until it was handled
+ */
+template <class Handled>
+static unsigned long runScan(HaCWifiManager &manager, unsigned long scanMs, bool event, Handled handled)
+{
+    unsigned long doneAt = millis() + scanMs;
+    unsigned long limit = millis() + RUN_LIMIT;
+    while (!handled() && (long)(millis() - limit) < 0)
+    {
+        tick();
+        // The scan ends between two loop passes
+        if ((long)(millis() - doneAt) >= 0 && WiFi.scanComplete() == WIFI_SCAN_RUNNING)
+        {
+            if (event) WiFi.completeScan(SCAN_RESULTS);
+            else WiFi.scanResult = SCAN_RESULTS;
+        }
+        manager.loop();
+    }
+    return millis() - doneAt;
+}
+
+/**
+ * Bring the station up on the first candidate, the background scan timer is then running.
+ */
+static void connectManager(HaCWifiManager &manager)
+{
+    setupManager(manager);
+    runScan(manager, 100, true, [&]() { return WiFi.beginCalls > 0; });
+    WiFi.associate();
+    loopPass(manager);
+}
+/* #endregion */
+
+void setUp()
+{
+    hacTestMillis() = 0;
+    hacTestMicros() = 0;
+    WiFi = ESP8266WiFiClass();
+}
+
+void tearDown() {}
+
+// The startup scan is ranked on the first loop after the scan done event, polling waited up to a second
+void test_startup_scan_latency()
+{
+    unsigned long eventTotal = 0;
+    unsigned long pollingTotal = 0;
+    for (unsigned long scanMs : scanDurations)
+    {
+        setUp();
+        HaCWifiManager manager;
+        setupManager(manager);
+        TEST_ASSERT_EQUAL(STA_SCANNING, manager.getStationState());
+
+        unsigned long latency = runScan(manager, scanMs, true,
+                                        [&]() { return manager.getStationState() != STA_SCANNING; });
+        TEST_ASSERT_EQUAL(STA_STARTING, manager.getStationState());
+        TEST_ASSERT_LESS_OR_EQUAL(LOOP_PERIOD, latency);
+        TEST_ASSERT_LESS_OR_EQUAL(pollingLatency(scanMs), latency);
+        eventTotal += latency;
+        pollingTotal += pollingLatency(scanMs);
+    }
+    TEST_ASSERT_LESS_THAN(pollingTotal / 10, eventTotal);
+}
+
+// Without the event the safety net picks the startup scan up after the scan timeout
+void test_startup_scan_safety_net()
+{
+    HaCWifiManager manager;
+    setupManager(manager);
+    unsigned long latency = runScan(manager, 200, false,
+                                    [&]() { return manager.getStationState() != STA_SCANNING; });
+    TEST_ASSERT_EQUAL(STA_STARTING, manager.getStationState());
+    TEST_ASSERT_LESS_OR_EQUAL(WIFI_SCAN_TIMEOUT - 200 + LOOP_PERIOD, latency);
+}
+
+// The background scan fills the fallback list on the first loop after the scan done event
+void test_background_scan_latency()
+{
+    unsigned long eventTotal = 0;
+    unsigned long pollingTotal = 0;
+    for (unsigned long scanMs : scanDurations)
+    {
+        setUp();
+        HaCWifiManager manager;
+        connectManager(manager);
+        TEST_ASSERT_EQUAL(STA_CONNECTED, manager.getStationState());
+        TEST_ASSERT_EQUAL(0, manager.getFallbackListCount());
+
+        // Wait for the background scan timer
+        unsigned long scanCalls = WiFi.scanCalls;
+        while (WiFi.scanCalls == scanCalls && millis() < 2 * BG_SCAN_INTERVAL) loopPass(manager);
+        TEST_ASSERT_EQUAL(scanCalls + 1, WiFi.scanCalls);
+
+        unsigned long latency = runScan(manager, scanMs, true,
+                                        [&]() { return manager.getFallbackListCount() > 0; });
+        TEST_ASSERT_EQUAL(SCAN_RESULTS, manager.getFallbackListCount());
+        TEST_ASSERT_LESS_OR_EQUAL(LOOP_PERIOD, latency);
+        TEST_ASSERT_LESS_OR_EQUAL(pollingLatency(scanMs), latency);
+        eventTotal += latency;
+        pollingTotal += pollingLatency(scanMs);
+    }
+    TEST_ASSERT_LESS_THAN(pollingTotal / 10, eventTotal);
+}
+
+// Without the event the background scan is collected on the next background scan period
+void test_background_scan_safety_net()
+{
+    HaCWifiManager manager;
+    connectManager(manager);
+    unsigned long scanCalls = WiFi.scanCalls;
+    while (WiFi.scanCalls == scanCalls && millis() < 2 * BG_SCAN_INTERVAL) loopPass(manager);
+
+    unsigned long latency = runScan(manager, 300, false, [&]() { return manager.getFallbackListCount() > 0; });
+    TEST_ASSERT_EQUAL(SCAN_RESULTS, manager.getFallbackListCount());
+    TEST_ASSERT_LESS_OR_EQUAL(BG_SCAN_INTERVAL - 300 + LOOP_PERIOD, latency);
+}
+
+// The scan wait survives the millis() rollover
+void test_scan_across_rollover()
+{
+    hacTestMillis() = (unsigned long)-300;
+    HaCWifiManager manager;
+    setupManager(manager);
+    unsigned long latency = runScan(manager, 500, true,
+                                    [&]() { return manager.getStationState() != STA_SCANNING; });
+    TEST_ASSERT_EQUAL(STA_STARTING, manager.getStationState());
+    TEST_ASSERT_LESS_OR_EQUAL(LOOP_PERIOD, latency);
+
+    setUp();
+    hacTestMillis() = (unsigned long)-300;
+    HaCWifiManager lost;
+    setupManager(lost);
+    latency = runScan(lost, 100, false, [&]() { return lost.getStationState() != STA_SCANNING; });
+    TEST_ASSERT_EQUAL(STA_STARTING, lost.getStationState());
+    TEST_ASSERT_LESS_OR_EQUAL(WIFI_SCAN_TIMEOUT - 100 + LOOP_PERIOD, latency);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_startup_scan_latency);
+    RUN_TEST(test_startup_scan_safety_net);
+    RUN_TEST(test_background_scan_latency);
+    RUN_TEST(test_background_scan_safety_net);
+    RUN_TEST(test_scan_across_rollover);
+    return UNITY_END();
+}
@@ -0,0 +1,160 @@
+/**
+ *
+ * @file test_startup_timing/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#define ESP8266
+#include <unity.h>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "HaCWifiManager.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+#define LOOP_PERIOD 5
+#define SCAN_ITEM_US 2000           // Collection cost of one scan result
+#define SCAN_RESULTS 12
+#define LOOP_BUDGET_US 5000
+
+typedef struct LoopTiming
+{
+    unsigned long passes = 0;
+    unsigned long maxLoopUs = 0;    // Clock advance within a pass
+    unsigned long sleeps = 0;       // Passes which called delay() or moved millis()
+    unsigned long staStartedAt = 0;
+    unsigned long apStartedAt = 0;
+    unsigned long rescanAt = 0;     // Time the next scan started after a failed one
+} t_loopTiming;
+
+/**
+ * Start a manager in both station and access point mode with a multi wifi scan.
+ */
+static void setupManager(HaCWifiManager &manager)
+{
+    manager.setMode(BOTH_STA_AP);
+    manager.setEnableMultiWifi(true);
+    manager.addWifiList("ssid", "pass");
+    manager.addWifiList("other", "pass");
+    manager.setAPInfo("ap", "appass");
+    manager.setLoopBudget(LOOP_BUDGET_US);
+    manager.setup();
+}
+
+/**
+ * Drive the manager loop until both interfaces are started, a scan is retried or the time is over.
+ * @param scanDoneAt Time the scan done event arrives, 0 for never
+ * @param untilMs Time the run ends at the latest
+ */
+static t_loopTiming runStartup(HaCWifiManager &manager, unsigned long scanDoneAt, unsigned long untilMs)
+{
+    t_loopTiming timing;
+    while (millis() < untilMs && timing.rescanAt == 0 && (timing.staStartedAt == 0 || timing.apStartedAt == 0))
+    {
+        hacTestMillis() += LOOP_PERIOD;
+        hacTestMicros() += LOOP_PERIOD * 1000;
+        if (scanDoneAt != 0 && millis() >= scanDoneAt && WiFi.scanComplete() == WIFI_SCAN_RUNNING)
+            WiFi.completeScan(SCAN_RESULTS);
+
+        unsigned long delayCalls = hacTestDelayCalls();
+        unsigned long passMs = millis();
+        unsigned long passUs = micros();
+        manager.loop();
+
+        // A pass never sleeps
+        if (hacTestDelayCalls() != delayCalls || millis() != passMs) timing.sleeps++;
+        timing.maxLoopUs = max(timing.maxLoopUs, micros() - passUs);
+        if (timing.staStartedAt == 0 && WiFi.beginCalls) timing.staStartedAt = millis();
+        if (timing.apStartedAt == 0 && WiFi.softAPCalls) timing.apStartedAt = millis();
+        if (WiFi.scanCalls > 1) timing.rescanAt = millis();
+        timing.passes++;
+    }
+    return timing;
+}
+/* #endregion */
+
+void setUp()
+{
+    hacTestMillis() = 0;
+    hacTestMicros() = 0;
+    hacTestDelayCalls() = 0;
+    WiFi = ESP8266WiFiClass();
+    WiFi.scanItemUs = SCAN_ITEM_US;
+}
+
+void tearDown() {}
+
+// setup() only starts the scan, the sequence runs from the loop
+void test_setup_returns_immediately()
+{
+    HaCWifiManager manager;
+    setupManager(manager);
+
+    TEST_ASSERT_EQUAL(0, hacTestDelayCalls());
+    TEST_ASSERT_EQUAL(0, millis());
+    TEST_ASSERT_EQUAL(1, WiFi.scanCalls);
+    TEST_ASSERT_EQUAL(0, WiFi.beginCalls);
+    TEST_ASSERT_EQUAL(0, WiFi.softAPCalls);
+}
+
+// Every loop pass returns within the budget while startup progresses
+void test_loop_passes_are_bounded()
+{
+    HaCWifiManager manager;
+    setupManager(manager);
+    t_loopTiming timing = runStartup(manager, 400, 10000);
+
+    TEST_ASSERT_EQUAL(0, timing.sleeps);
+    TEST_ASSERT_LESS_OR_EQUAL(LOOP_BUDGET_US, timing.maxLoopUs);
+    TEST_ASSERT_NOT_EQUAL(0, timing.staStartedAt);
+    TEST_ASSERT_NOT_EQUAL(0, timing.apStartedAt);
+    // Station up one settle delay after the sliced collection, access point one settle delay after setup()
+    unsigned long collectPasses = SCAN_RESULTS / (LOOP_BUDGET_US / SCAN_ITEM_US);
+    TEST_ASSERT_LESS_OR_EQUAL(400 + (collectPasses + 2) * LOOP_PERIOD + STARTUP_SETTLE_DELAY, timing.staStartedAt);
+    TEST_ASSERT_LESS_OR_EQUAL(STARTUP_SETTLE_DELAY + LOOP_PERIOD, timing.apStartedAt);
+}
+
+// A lost scan event gives up on the attempt limit and rescans after the backoff, without blocking
+void test_scan_failure_is_bounded()
+{
+    HaCWifiManager manager;
+    setupManager(manager);
+    t_loopTiming timing = runStartup(manager, 0, 30000);
+
+    TEST_ASSERT_EQUAL(0, timing.sleeps);
+    TEST_ASSERT_LESS_OR_EQUAL(LOOP_BUDGET_US, timing.maxLoopUs);
+    TEST_ASSERT_EQUAL(0, timing.staStartedAt);
+    TEST_ASSERT_NOT_EQUAL(0, timing.rescanAt);
+    // First backoff delay is at most three times the base
+    TEST_ASSERT_LESS_OR_EQUAL((MAX_WIFI_SCAN_ATTEMPT + 1) * (WIFI_SCAN_TIMEOUT + LOOP_PERIOD) + 3 * BACKOFF_BASE + LOOP_PERIOD,
+                              timing.rescanAt);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_setup_returns_immediately);
+    RUN_TEST(test_loop_passes_are_bounded);
+    RUN_TEST(test_scan_failure_is_bounded);
+    return UNITY_END();
+}
@@ -0,0 +1,157 @@
+/**
+ *
+ * @file test_station_state/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <unity.h>
+#include <stdio.h>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "stationstate.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+#define S(state) (1 << (state))
+
+//Expected next states, written out independently of the table under test
+static const uint8_t EXPECTED[STA_STATE_COUNT] = {
+    /* STA_IDLE */ S(STA_STARTING) | S(STA_SCANNING) | S(STA_ASSOCIATING) | S(STA_CONNECTED) | S(STA_BACKOFF),
+    /* STA_STARTING */ S(STA_IDLE) | S(STA_SCANNING) | S(STA_ASSOCIATING) | S(STA_CONNECTED) | S(STA_BACKOFF),
+    /* STA_SCANNING */ S(STA_IDLE) | S(STA_STARTING) | S(STA_ASSOCIATING) | S(STA_CONNECTED) | S(STA_BACKOFF),
+    /* STA_ASSOCIATING */ S(STA_IDLE) | S(STA_DHCP) | S(STA_CONNECTED) | S(STA_BACKOFF),
+    /* STA_DHCP */ S(STA_IDLE) | S(STA_ASSOCIATING) | S(STA_CONNECTED) | S(STA_BACKOFF),
+    /* STA_CONNECTED */ S(STA_IDLE),
+    /* STA_BACKOFF */ S(STA_IDLE) | S(STA_STARTING) | S(STA_SCANNING) | S(STA_ASSOCIATING) | S(STA_CONNECTED),
+};
+
+/**
+ * Walk the machine through a sequence of states.
+ * @return Number of accepted transitions
+ */
+static uint8_t walk(HaCStationStateMachine &machine, const StationState *states, uint8_t count)
+{
+    uint8_t accepted = 0;
+    for (uint8_t i = 0; i < count; i++)
+        if (machine.transition(states[i])) accepted++;
+    return accepted;
+}
+/* #endregion */
+
+void setUp()
+{
+    hacTestMillis() = 0;
+}
+
+void tearDown() {}
+
+void test_transition_table()
+{
+    for (uint8_t from = 0; from < STA_STATE_COUNT; from++)
+    {
+        for (uint8_t to = 0; to < STA_STATE_COUNT; to++)
+        {
+            bool expected = from == to || (EXPECTED[from] & S(to)) != 0;
+            char msg[40];
+            snprintf(msg, sizeof(msg), "%s -> %s", HaCStationStateMachine::name((StationState)from),
+                     HaCStationStateMachine::name((StationState)to));
+            if (HaCStationStateMachine::allowed((StationState)from, (StationState)to) != expected) TEST_MESSAGE(msg);
+            TEST_ASSERT_EQUAL(expected, HaCStationStateMachine::allowed((StationState)from, (StationState)to));
+        }
+    }
+    TEST_ASSERT_FALSE(HaCStationStateMachine::allowed(STA_STATE_COUNT, STA_IDLE));
+    TEST_ASSERT_FALSE(HaCStationStateMachine::allowed(STA_IDLE, STA_STATE_COUNT));
+}
+
+// A connected station has to go down before it is set up again
+void test_resetup_from_connected()
+{
+    HaCStationStateMachine machine;
+    const StationState connect[] = {STA_STARTING, STA_ASSOCIATING, STA_DHCP, STA_CONNECTED};
+    TEST_ASSERT_EQUAL(4, walk(machine, connect, 4));
+
+    TEST_ASSERT_FALSE(machine.transition(STA_SCANNING));
+    TEST_ASSERT_FALSE(machine.transition(STA_STARTING));
+    TEST_ASSERT_EQUAL(STA_CONNECTED, machine.state());
+
+    // What the station stop does before the multi or single wifi setup
+    TEST_ASSERT_TRUE(machine.transition(STA_IDLE));
+    TEST_ASSERT_TRUE(machine.transition(STA_SCANNING));
+    TEST_ASSERT_TRUE(machine.transition(STA_STARTING));
+}
+
+// Scan, attempt, failure, backoff and recovery
+void test_reconnect_cycle()
+{
+    HaCStationStateMachine machine;
+    const StationState cycle[] = {STA_SCANNING, STA_STARTING, STA_ASSOCIATING, STA_BACKOFF,
+                                  STA_SCANNING, STA_STARTING, STA_ASSOCIATING, STA_DHCP, STA_CONNECTED};
+    TEST_ASSERT_EQUAL(9, walk(machine, cycle, 9));
+    TEST_ASSERT_FALSE(machine.isConnecting());
+    TEST_ASSERT_FALSE(machine.transition(STA_DHCP));
+}
+
+void test_is_connecting()
+{
+    HaCStationStateMachine machine;
+    TEST_ASSERT_FALSE(machine.isConnecting());
+    machine.transition(STA_ASSOCIATING);
+    TEST_ASSERT_TRUE(machine.isConnecting());
+    machine.transition(STA_DHCP);
+    TEST_ASSERT_TRUE(machine.isConnecting());
+    machine.transition(STA_BACKOFF);
+    TEST_ASSERT_FALSE(machine.isConnecting());
+}
+
+// Time in state restarts on every accepted transition only, across the millis() rollover
+void test_time_in_state()
+{
+    hacTestMillis() = (unsigned long)-500;
+    HaCStationStateMachine machine;
+    machine.transition(STA_STARTING);
+    hacTestMillis() += 800;
+    TEST_ASSERT_EQUAL(800, machine.timeInState());
+    TEST_ASSERT_FALSE(machine.transition(STA_DHCP));
+    TEST_ASSERT_EQUAL(800, machine.timeInState());
+    TEST_ASSERT_TRUE(machine.transition(STA_STARTING));
+    TEST_ASSERT_EQUAL(0, machine.timeInState());
+}
+
+void test_state_names()
+{
+    TEST_ASSERT_EQUAL_STRING("IDLE", HaCStationStateMachine::name(STA_IDLE));
+    TEST_ASSERT_EQUAL_STRING("BACKOFF", HaCStationStateMachine::name(STA_BACKOFF));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", HaCStationStateMachine::name(STA_STATE_COUNT));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_transition_table);
+    RUN_TEST(test_resetup_from_connected);
+    RUN_TEST(test_reconnect_cycle);
+    RUN_TEST(test_is_connecting);
+    RUN_TEST(test_time_in_state);
+    RUN_TEST(test_state_names);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+/**
+ *
+ * @file test_task_primitives/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "spscring.h"
+#include "seqlock.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+#define STRESS_ITEMS 200000
+#define STRESS_WRITES 200000
+
+typedef struct StressEvent
+{
+    uint32_t id;
+    uint32_t check;                 // Derived from the id, a torn copy does not match
+    char data[40];
+} t_stressEvent;
+
+typedef struct StressStatus
+{
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint8_t pad[64];
+} t_stressStatus;
+
+static void fillStatus(t_stressStatus &status, uint32_t value)
+{
+    status.a = value;
+    status.b = value * 3;
+    status.c = ~value;
+    memset(status.pad, value & 0xff, sizeof(status.pad));
+}
+
+static bool statusIsConsistent(const t_stressStatus &status)
+{
+    if (status.b != status.a * 3 || status.c != ~status.a) return false;
+    for (size_t i = 0; i < sizeof(status.pad); i++)
+        if (status.pad[i] != (status.a & 0xff)) return false;
+    return true;
+}
+/* #endregion */
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// The manager task pushes events while the application loop pops them
+void test_ring_keeps_order_across_threads()
+{
+    HaCSpscRing<t_stressEvent, 16> ring;
+    std::thread producer([&]() {
+        t_stressEvent event;
+        for (uint32_t id = 0; id < STRESS_ITEMS; id++)
+        {
+            event.id = id;
+            event.check = id * 2654435761u;
+            snprintf(event.data, sizeof(event.data), "event %lu", (unsigned long)id);
+            while (!ring.push(event)) std::this_thread::yield();
+        }
+    });
+
+    t_stressEvent event;
+    uint32_t expected = 0;
+    uint32_t outOfOrder = 0;
+    uint32_t torn = 0;
+    char data[40];
+    while (expected < STRESS_ITEMS)
+    {
+        if (!ring.pop(event))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if (event.id != expected) outOfOrder++;
+        snprintf(data, sizeof(data), "event %lu", (unsigned long)event.id);
+        if (event.check != event.id * 2654435761u || strcmp(data, event.data) != 0) torn++;
+        expected = event.id + 1;
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL(0, outOfOrder);
+    TEST_ASSERT_EQUAL(0, torn);
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+// A full ring refuses the item instead of overwriting the oldest one
+void test_ring_full_refuses_push()
+{
+    HaCSpscRing<uint32_t, 4> ring;
+    for (uint32_t i = 0; i < 4; i++) TEST_ASSERT_TRUE(ring.push(i));
+    TEST_ASSERT_FALSE(ring.push(4));
+    TEST_ASSERT_EQUAL(4, ring.size());
+
+    uint32_t item = 0;
+    TEST_ASSERT_TRUE(ring.pop(item));
+    TEST_ASSERT_EQUAL(0, item);
+    TEST_ASSERT_TRUE(ring.push(4));
+}
+
+// Readers on other threads never see a half written status
+void test_seqlock_readers_see_whole_snapshots()
+{
+    HaCSeqLock<t_stressStatus> lock;
+    t_stressStatus initial;
+    fillStatus(initial, 0);
+    lock.write(initial);
+
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        t_stressStatus status;
+        for (uint32_t value = 1; value <= STRESS_WRITES; value++)
+        {
+            fillStatus(status, value);
+            lock.write(status);
+        }
+        done = true;
+    });
+
+    uint32_t reads = 0;
+    uint32_t torn = 0;
+    uint32_t backwards = 0;
+    uint32_t last = 0;
+    t_stressStatus status;
+    while (!done)
+    {
+        if (!lock.read(status)) continue;
+        reads++;
+        if (!statusIsConsistent(status)) torn++;
+        if (status.a < last) backwards++;
+        last = status.a;
+    }
+    writer.join();
+
+    TEST_ASSERT_TRUE(lock.read(status));
+    TEST_ASSERT_TRUE(reads > 0);
+    TEST_ASSERT_EQUAL(0, torn);
+    TEST_ASSERT_EQUAL(0, backwards);
+    TEST_ASSERT_EQUAL(STRESS_WRITES, status.a);
+    TEST_ASSERT_EQUAL((STRESS_WRITES + 1) * 2, lock.sequence());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_keeps_order_across_threads);
+    RUN_TEST(test_ring_full_refuses_push);
+    RUN_TEST(test_seqlock_readers_see_whole_snapshots);
+    return UNITY_END();
+}
@@ -0,0 +1,156 @@
+/**
+ *
+ * @file test_tick_bench/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "tick.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+#define IDLE_LOOPS 100000
+#define MAX_IDLE_HANDLE_NS 500      // Loop cost with no timer due, whatever the timer count
+
+static unsigned long fired = 0;
+
+/**
+ * Arm count timers of 1 to 997 ms, kept in a growing vector.
+ */
+static void armTimers(std::vector<Tick> &timers, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        timers.push_back(Tick(1 + (i * 7919UL) % 997));
+        timers.back().onTick([]() { fired++; });
+        timers.back().begin();
+    }
+}
+
+static double elapsedNs(std::chrono::steady_clock::time_point start)
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+/* #endregion */
+
+void setUp()
+{
+    hacTestMillis() = 0;
+    fired = 0;
+}
+
+void tearDown() {}
+
+// Moving armed timers keeps them armed, a vector reallocation does not lose any
+void test_vector_of_armed_timers()
+{
+    std::vector<Tick> timers;
+    armTimers(timers, 100);
+    TEST_ASSERT_EQUAL(100, TickScheduler::instance().size());
+    for (Tick &timer : timers) TEST_ASSERT_TRUE(timer.isRunning());
+
+    hacTestMillis() += 1000;
+    TickScheduler::instance().handle();
+    TEST_ASSERT_EQUAL(100, fired);
+
+    Tick moved = std::move(timers[0]);
+    TEST_ASSERT_TRUE(moved.isRunning());
+    TEST_ASSERT_FALSE(timers[0].isRunning());
+    TEST_ASSERT_EQUAL(100, TickScheduler::instance().size());
+
+    // A copy takes the setup only
+    Tick copy = timers[1];
+    TEST_ASSERT_FALSE(copy.isRunning());
+    TEST_ASSERT_TRUE(timers[1].isRunning());
+
+    timers.clear();
+    TEST_ASSERT_EQUAL(1, TickScheduler::instance().size());
+    moved.stop();
+    TEST_ASSERT_EQUAL(0, TickScheduler::instance().size());
+}
+
+// The loop only looks at the earliest deadline, its cost does not grow with the timers
+void test_idle_handle_cost()
+{
+    const uint16_t counts[] = {10, 100, 1000};
+    for (uint16_t count : counts)
+    {
+        std::vector<Tick> timers;
+        armTimers(timers, count);
+        hacTestMillis() = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < IDLE_LOOPS; i++) TickScheduler::instance().handle();
+        double ns = elapsedNs(start) / IDLE_LOOPS;
+
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%u timers: %.1f ns per idle loop", count, ns);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_EQUAL(0, fired);
+        TEST_ASSERT_LESS_OR_EQUAL(MAX_IDLE_HANDLE_NS, (unsigned long)ns);
+    }
+}
+
+// Every timer fires on time, the cost per fired timer grows with the heap depth only
+void test_fire_cost()
+{
+    const uint16_t counts[] = {10, 100, 1000};
+    double perFire[3];
+    for (uint8_t n = 0; n < 3; n++)
+    {
+        std::vector<Tick> timers;
+        armTimers(timers, counts[n]);
+        fired = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint16_t ms = 0; ms < 10000; ms++)
+        {
+            hacTestMillis()++;
+            TickScheduler::instance().handle();
+        }
+        perFire[n] = elapsedNs(start) / fired;
+
+        // Each timer fires every duration + 1 ms over 10 s
+        unsigned long expected = 0;
+        for (uint16_t i = 0; i < counts[n]; i++) expected += 10000 / (2 + (i * 7919UL) % 997);
+        char msg[72];
+        snprintf(msg, sizeof(msg), "%u timers: %lu fired, %.1f ns per fired timer", counts[n], fired, perFire[n]);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_EQUAL(expected, fired);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL((unsigned long)(10 * perFire[0] + 1000), (unsigned long)perFire[2]);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_vector_of_armed_timers);
+    RUN_TEST(test_idle_handle_cost);
+    RUN_TEST(test_fire_cost);
+    return UNITY_END();
+}
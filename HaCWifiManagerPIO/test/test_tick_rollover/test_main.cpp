@@ -0,0 +1,221 @@
+/**
+ *
+ * @file test_tick_rollover/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <unity.h>
+#include <vector>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "tick.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+static std::vector<unsigned long> firedAt;
+
+static void recordMs()
+{
+    firedAt.push_back(millis());
+}
+
+/**
+ * Run the millisecond loop for a duration.
+ * @param latency Loop period, the latency a timer sees
+ */
+static void runMs(unsigned long duration, unsigned long latency = 1)
+{
+    for (unsigned long elapsed = 0; elapsed < duration; elapsed += latency)
+    {
+        hacTestMillis() += latency;
+        TickScheduler::instance().handle();
+    }
+}
+/* #endregion */
+
+void setUp()
+{
+    hacTestMillis() = 0;
+    hacTestMicros() = 0;
+    firedAt.clear();
+}
+
+void tearDown() {}
+
+void test_one_shot_fires_once()
+{
+    Tick timer(100);
+    timer.onTick(recordMs);
+    timer.beginOnce();
+    runMs(1000);
+    TEST_ASSERT_EQUAL(1, firedAt.size());
+    TEST_ASSERT_EQUAL(100, firedAt[0]);
+    TEST_ASSERT_FALSE(timer.isRunning());
+}
+
+// Periodic keeps the historical behaviour, rearmed from the time it fired
+void test_periodic_rearms_from_now()
+{
+    Tick timer(100);
+    timer.onTick(recordMs);
+    timer.begin();
+    runMs(1000, 7);
+    TEST_ASSERT_GREATER_OR_EQUAL(2, firedAt.size());
+    for (size_t i = 1; i < firedAt.size(); i++) TEST_ASSERT_GREATER_THAN(100, firedAt[i] - firedAt[i - 1]);
+}
+
+// Fixed rate keeps the phase whatever the loop latency
+void test_fixed_rate_has_no_drift()
+{
+    Tick timer(100);
+    timer.onTick(recordMs);
+    timer.beginFixedRate();
+    runMs(10000, 7);
+    TEST_ASSERT_EQUAL(100, firedAt.size());
+    for (size_t i = 0; i < firedAt.size(); i++)
+    {
+        // Late by the loop period at most, never accumulated
+        TEST_ASSERT_GREATER_OR_EQUAL((i + 1) * 100, firedAt[i]);
+        TEST_ASSERT_LESS_THAN((i + 1) * 100 + 7, firedAt[i]);
+    }
+}
+
+// A blocked loop skips the missed periods instead of firing a burst
+void test_fixed_rate_skips_missed_periods()
+{
+    Tick timer(100);
+    timer.onTick(recordMs);
+    timer.beginFixedRate();
+    hacTestMillis() = 1050;
+    TickScheduler::instance().handle();
+    TEST_ASSERT_EQUAL(1, firedAt.size());
+    runMs(200);
+    TEST_ASSERT_EQUAL(3, firedAt.size());
+    TEST_ASSERT_EQUAL(1100, firedAt[1]);
+    TEST_ASSERT_EQUAL(1200, firedAt[2]);
+}
+
+// Deadlines past the millis() rollover fire on time, in order
+void test_millis_rollover()
+{
+    hacTestMillis() = (unsigned long)-150;
+    Tick early(100), late(300), fixed(100);
+    std::vector<int> order;
+    early.onTick([&order]() { order.push_back(1); });
+    late.onTick([&order]() { order.push_back(2); });
+    fixed.onTick(recordMs);
+    late.beginOnce();
+    early.beginOnce();
+    fixed.beginFixedRate();
+
+    runMs(100);
+    TEST_ASSERT_EQUAL(1, order.size());
+    TEST_ASSERT_EQUAL(1, firedAt.size());
+    TEST_ASSERT_TRUE(firedAt[0] == (unsigned long)-50);
+    // Next deadline is the fixed rate one, past the rollover
+    TEST_ASSERT_EQUAL(100, TickScheduler::instance().timeToNext());
+
+    runMs(200);
+    TEST_ASSERT_EQUAL(2, order.size());
+    TEST_ASSERT_EQUAL(1, order[0]);
+    TEST_ASSERT_EQUAL(2, order[1]);
+    // The fixed rate timer crossed the rollover without drift
+    TEST_ASSERT_EQUAL(3, firedAt.size());
+    TEST_ASSERT_EQUAL(50, firedAt[1]);
+    TEST_ASSERT_EQUAL(150, firedAt[2]);
+}
+
+// Sub-millisecond timers on micros(), across its rollover
+void test_micros_timer_rollover()
+{
+    hacTestMicros() = (unsigned long)-1000;
+    std::vector<unsigned long> at;
+    TickUs timer(250);
+    timer.onTick([&at]() { at.push_back(micros()); });
+    timer.beginFixedRate();
+
+    for (uint16_t i = 0; i < 2000; i++)
+    {
+        hacTestMicros()++;
+        TickSchedulerUs::instance().handle();
+    }
+    TEST_ASSERT_EQUAL(8, at.size());
+    TEST_ASSERT_TRUE(at[0] == (unsigned long)-750);
+    TEST_ASSERT_TRUE(at[3] == 0);
+    TEST_ASSERT_EQUAL(1000, at[7]);
+    timer.stop();
+    TEST_ASSERT_EQUAL(TICK_NO_DEADLINE, TickSchedulerUs::instance().timeToNext());
+}
+
+// A timer may stop or restart itself from its callback
+void test_callback_rearms_its_timer()
+{
+    Tick timer(50);
+    uint8_t count = 0;
+    timer.onTick([&]() {
+        if (++count == 3) timer.stop();
+        else timer.beginOnce();
+    });
+    timer.beginOnce();
+    runMs(1000);
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL(0, TickScheduler::instance().size());
+}
+
+// A zero duration timer rearmed from its callback fires once per pass
+void test_zero_duration_rearm_yields()
+{
+    Tick timer(0);
+    Tick other(0);
+    unsigned long count = 0;
+    timer.onTick([&]() {
+        count++;
+        timer.beginOnce();
+    });
+    other.onTick(recordMs);
+    timer.beginOnce();
+    other.beginOnce();
+    TickScheduler::instance().handle();
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL(1, firedAt.size());
+    TEST_ASSERT_EQUAL(0, TickScheduler::instance().timeToNext());
+
+    runMs(10);
+    TEST_ASSERT_EQUAL(11, count);
+    timer.stop();
+    TEST_ASSERT_EQUAL(0, TickScheduler::instance().size());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_one_shot_fires_once);
+    RUN_TEST(test_periodic_rearms_from_now);
+    RUN_TEST(test_fixed_rate_has_no_drift);
+    RUN_TEST(test_fixed_rate_skips_missed_periods);
+    RUN_TEST(test_millis_rollover);
+    RUN_TEST(test_micros_timer_rollover);
+    RUN_TEST(test_callback_rearms_its_timer);
+    RUN_TEST(test_zero_duration_rearm_yields);
+    return UNITY_END();
+}
@@ -0,0 +1,215 @@
+/**
+ *
+ * @file test_tickless_idle/test_main.cpp
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <unity.h>
+#include <stdio.h>
+/* #endregion */
+
+/* #region INTERNAL_DEPENDENCY */
+#include "hacflow.h"
+#include "tick.h"
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+#define HOUR 3600000UL
+
+/**
+ * Timer which checks it is never fired before or after its deadline.
+ */
+struct WatchedTimer
+{
+    Tick tick;
+    unsigned long period;
+    unsigned long expected = 0;
+    unsigned long fired = 0;
+    unsigned long maxLateMs = 0;
+    unsigned long early = 0;
+
+    WatchedTimer(unsigned long period) : tick(period), period(period) {}
+
+    // Periodic timers fire once more than the period elapsed
+    unsigned long interval(bool fixedRate) const
+    {
+        return this->period + (fixedRate ? 0 : 1);
+    }
+
+    void arm(bool fixedRate)
+    {
+        this->expected = millis() + this->interval(fixedRate);
+        this->tick.onTick([this, fixedRate]() {
+            long late = (long)(millis() - this->expected);
+            if (late < 0) this->early++;
+            else if ((unsigned long)late > this->maxLateMs) this->maxLateMs = late;
+            this->fired++;
+            // Fixed rate keeps the phase, periodic is rearmed from now
+            this->expected = (fixedRate ? this->expected : millis()) + this->interval(fixedRate);
+        });
+        if (fixedRate) this->tick.beginFixedRate();
+        else this->tick.begin();
+    }
+};
+
+/**
+ * Time the loop may sleep, composed like HaCWifiManager::nextWakeupMs().
+ */
+static unsigned long nextWakeup(const HaCFlow &flow)
+{
+    unsigned long wakeup = TickScheduler::instance().timeToNext();
+    unsigned long wakeupUs = TickSchedulerUs::instance().timeToNext();
+    if (wakeupUs != TICK_NO_DEADLINE && wakeupUs / 1000 < wakeup) wakeup = wakeupUs / 1000;
+    if (flow.timeToTimeout() < wakeup) wakeup = flow.timeToTimeout();
+    return wakeup;
+}
+
+static void advance(unsigned long ms)
+{
+    hacTestMillis() += ms;
+    hacTestMicros() += ms * 1000;
+}
+
+typedef struct IdleRun
+{
+    unsigned long wakeups = 0;
+    unsigned long busyPasses = 0;   // Passes which found the next deadline due
+} t_idleRun;
+
+/**
+ * Sleep until the next deadline over and over, as a light sleeping loop would.
+ * @param overshootMs Sleep overshoot of the board, the loop wakes up late by up to this
+ */
+static t_idleRun idle(HaCFlow &flow, unsigned long durationMs, unsigned long overshootMs)
+{
+    t_idleRun run;
+    unsigned long end = millis() + durationMs;
+    uint32_t jitter = 12345;
+    while ((long)(millis() - end) < 0)
+    {
+        unsigned long wakeup = nextWakeup(flow);
+        if (wakeup == TICK_NO_DEADLINE) break;
+        if (wakeup == 0) run.busyPasses++;
+
+        jitter = jitter * 1103515245 + 12345;
+        advance(wakeup + (overshootMs ? (jitter >> 16) % (overshootMs + 1) : 0));
+        run.wakeups++;
+        TickScheduler::instance().handle();
+        TickSchedulerUs::instance().handle();
+        // A flow waiting again after its timeout, as the scan safety net does
+        if (flow.isRunning() && flow.timedOut()) flow.wait(1, 1000);
+    }
+    return run;
+}
+/* #endregion */
+
+void setUp()
+{
+    hacTestMillis() = 0;
+    hacTestMicros() = 0;
+}
+
+void tearDown() {}
+
+// Nothing armed, the loop can sleep until a wifi event
+void test_no_deadline_when_idle()
+{
+    HaCFlow flow;
+    TEST_ASSERT_EQUAL(TICK_NO_DEADLINE, nextWakeup(flow));
+}
+
+// A day of idle sleeps, each timer fires exactly on its deadline
+void test_long_idle_without_missed_deadline()
+{
+    WatchedTimer status(1000), bgScan(60000), reconnect(45000);
+    status.arm(false);
+    bgScan.arm(true);
+    reconnect.arm(false);
+
+    HaCFlow flow;
+    t_idleRun run = idle(flow, 24 * HOUR, 0);
+
+    TEST_ASSERT_EQUAL(0, status.early + bgScan.early + reconnect.early);
+    TEST_ASSERT_EQUAL(0, status.maxLateMs);
+    TEST_ASSERT_EQUAL(0, bgScan.maxLateMs);
+    TEST_ASSERT_EQUAL(0, reconnect.maxLateMs);
+    TEST_ASSERT_EQUAL(24 * HOUR / 60000, bgScan.fired);
+    TEST_ASSERT_EQUAL(24 * HOUR / 1001, status.fired);
+    // One wakeup per deadline, never a spinning loop
+    TEST_ASSERT_EQUAL(0, run.busyPasses);
+    TEST_ASSERT_LESS_OR_EQUAL(status.fired + bgScan.fired + reconnect.fired, run.wakeups);
+}
+
+// A board waking up late delays the timers by the overshoot but never drops one
+void test_sleep_overshoot()
+{
+    WatchedTimer bgScan(60000);
+    bgScan.arm(true);
+    TickUs sample(1500);
+    unsigned long samples = 0;
+    sample.onTick([&samples]() { samples++; });
+    sample.beginFixedRate();
+
+    HaCFlow flow;
+    idle(flow, 2 * HOUR, 3);
+    TEST_ASSERT_EQUAL(0, bgScan.early);
+    TEST_ASSERT_LESS_OR_EQUAL(3, bgScan.maxLateMs);
+    TEST_ASSERT_EQUAL(2 * HOUR / 60000, bgScan.fired);
+    TEST_ASSERT_GREATER_THAN(0, samples);
+}
+
+// Flow waits bound the sleep like the timers
+void test_flow_wait_bounds_sleep()
+{
+    HaCFlow flow;
+    flow.restart();
+    flow.wait(1, 1000);
+    TEST_ASSERT_EQUAL(1000, nextWakeup(flow));
+    t_idleRun run = idle(flow, 10000, 0);
+    TEST_ASSERT_EQUAL(10, run.wakeups);
+    flow.stop();
+}
+
+// Long idle across the millis() rollover
+void test_long_idle_across_rollover()
+{
+    hacTestMillis() = (unsigned long)-(12 * HOUR);
+    WatchedTimer bgScan(60000);
+    bgScan.arm(true);
+
+    HaCFlow flow;
+    idle(flow, 24 * HOUR, 0);
+    TEST_ASSERT_EQUAL(0, bgScan.early);
+    TEST_ASSERT_EQUAL(0, bgScan.maxLateMs);
+    TEST_ASSERT_EQUAL(24 * HOUR / 60000, bgScan.fired);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_no_deadline_when_idle);
+    RUN_TEST(test_long_idle_without_missed_deadline);
+    RUN_TEST(test_sleep_overshoot);
+    RUN_TEST(test_flow_wait_bounds_sleep);
+    RUN_TEST(test_long_idle_across_rollover);
+    return UNITY_END();
+}
@@ -78,6 +78,33 @@ const char HAC_WFM_VERBOSE_MSG113[] PROGMEM = "Failed to setup Sec. DNS manually
 const char HAC_WFM_VERBOSE_MSG114[] PROGMEM = "AP SSID = %s";
 const char HAC_WFM_VERBOSE_MSG115[] PROGMEM = "AP PASS = %s";
 const char HAC_WFM_VERBOSE_MSG116[] PROGMEM = "MDNS = %s.local";
+const char HAC_WFM_VERBOSE_MSG117[] PROGMEM = "Background scan done. Fallback candidates = %d";
+const char HAC_WFM_VERBOSE_MSG118[] PROGMEM = "Fallback candidate = %s, RSSI = %d";
+const char HAC_WFM_VERBOSE_MSG119[] PROGMEM = "Trying next candidate = %s";
+const char HAC_WFM_VERBOSE_MSG120[] PROGMEM = "Connection attempt failed. Status = %d";
+const char HAC_WFM_VERBOSE_MSG121[] PROGMEM = "Time to IP = %lu ms, next deadline = %lu ms";
+const char HAC_WFM_VERBOSE_MSG122[] PROGMEM = "Station watchdog deadline = %lu ms";
+const char HAC_WFM_VERBOSE_MSG123[] PROGMEM = "Reconnect scheduled in %lu ms. Attempt = %d";
+const char HAC_WFM_VERBOSE_MSG124[] PROGMEM = "Weak signal, looking for a better access point. RSSI = %d";
+const char HAC_WFM_VERBOSE_MSG125[] PROGMEM = "Roaming to %s. RSSI %d -> %d";
+const char HAC_WFM_VERBOSE_MSG126[] PROGMEM = "Disconnect reason = %d, recovery action = %d";
+const char HAC_WFM_VERBOSE_MSG127[] PROGMEM = "Network %s quarantined for %lu ms";
+const char HAC_WFM_VERBOSE_MSG128[] PROGMEM = "Network %s is quarantined, skipping";
+const char HAC_WFM_VERBOSE_MSG129[] PROGMEM = "Associated in %lu ms, waiting for IP";
+const char HAC_WFM_VERBOSE_MSG130[] PROGMEM = "No IP after %lu ms, restarting DHCP. Restart = %d";
+const char HAC_WFM_VERBOSE_MSG131[] PROGMEM = "network profile = %d";
+const char HAC_WFM_VERBOSE_MSG132[] PROGMEM = "Reusing DHCP lease ip = %s, age = %lu ms";
+const char HAC_WFM_VERBOSE_MSG133[] PROGMEM = "Gateway %s did not answer, discarding the DHCP lease";
+const char HAC_WFM_VERBOSE_MSG134[] PROGMEM = "Station state %s -> %s";
+const char HAC_WFM_VERBOSE_MSG135[] PROGMEM = "Station state transition %s -> %s rejected";
+const char HAC_WFM_VERBOSE_MSG136[] PROGMEM = "Reload done. STA restarted = %d, AP restarted = %d, AP downtime = %lu ms";
+const char HAC_WFM_VERBOSE_MSG137[] PROGMEM = "Station back after reload, downtime = %lu ms";
+const char HAC_WFM_VERBOSE_MSG138[] PROGMEM = "Manager task started on core %d";
+const char HAC_WFM_VERBOSE_MSG139[] PROGMEM = "Request %lu started, type = %d, ssid = %s";
+const char HAC_WFM_VERBOSE_MSG140[] PROGMEM = "Request %lu done, result = %d, elapsed = %lu ms";
+const char HAC_WFM_VERBOSE_MSG141[] PROGMEM = "Address %s is used by another host, discarding the DHCP lease";
+const char HAC_WFM_VERBOSE_MSG142[] PROGMEM = "DHCP took over the reused lease, ip = %s, lease time = %lu s";
+const char HAC_WFM_VERBOSE_MSG143[] PROGMEM = "Static network of %s has no ip or gateway, using DHCP";
 
 
 /* #endregion */
@@ -0,0 +1,118 @@
+/**
+ *
+ * @file backoff-impl.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region SELF_HEADER */
+#include "backoff.h"
+/* #endregion */
+
+/* #region CLASS_DEFINITION */
+HaCBackoff::HaCBackoff(){}
+HaCBackoff::HaCBackoff(unsigned long baseMs, unsigned long capMs)
+{
+    this->_baseMs = baseMs;
+    this->_capMs = capMs < baseMs ? baseMs : capMs;
+    this->_sleepMs = baseMs;
+}
+
+/**
+     * Seeding the jitter generator.
+     * @param seed Device specific seed, 0 is ignored.
+     */
+void HaCBackoff::seed(uint32_t seed)
+{
+    if (seed != 0) this->_state = seed;
+}
+
+/**
+     * Seeding the jitter generator from the device mac address.
+     * @param mac 6 bytes mac address
+     */
+void HaCBackoff::seed(const uint8_t *mac)
+{
+    //FNV-1a hash of the mac address
+    uint32_t hash = 2166136261UL;
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        hash ^= mac[i];
+        hash *= 16777619UL;
+    }
+    this->seed(hash);
+}
+
+/**
+     * Getting the next reconnect delay.
+     * @return Delay in millisecond
+     */
+unsigned long HaCBackoff::next()
+{
+    unsigned long upper = this->_sleepMs * 3;
+    if (upper > this->_capMs || upper < this->_sleepMs) upper = this->_capMs;
+
+    unsigned long sleep = this->_baseMs;
+    if (upper > this->_baseMs)
+        sleep += this->_random() % (upper - this->_baseMs + 1);
+
+    this->_sleepMs = sleep;
+    if (this->_attempts < 0xFFFF) this->_attempts++;
+    return sleep;
+}
+
+/**
+     * Getting a short jittered delay, it counts as an attempt.
+     * Note: Used for a first retry which should not wait the base delay, the
+     * devices of a fleet still spread over the span.
+     * @param spanMs Longest delay in millisecond
+     * @return Delay in millisecond
+     */
+unsigned long HaCBackoff::jitter(unsigned long spanMs)
+{
+    if (this->_attempts < 0xFFFF) this->_attempts++;
+    return spanMs ? this->_random() % spanMs : 0;
+}
+
+/**
+     * Reset the backoff after a successful connection.
+     */
+void HaCBackoff::reset()
+{
+    this->_sleepMs = this->_baseMs;
+    this->_attempts = 0;
+}
+
+uint16_t HaCBackoff::attempts()
+{
+    return this->_attempts;
+}
+
+/**
+     * Xorshift32 pseudo random generator.
+     */
+uint32_t HaCBackoff::_random()
+{
+    this->_state ^= this->_state << 13;
+    this->_state ^= this->_state >> 17;
+    this->_state ^= this->_state << 5;
+    return this->_state;
+}
+/* #endregion */
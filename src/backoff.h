@@ -0,0 +1,68 @@
+/**
+ *
+ * @file backoff.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef __BACKOFF_H_
+#define __BACKOFF_H_
+
+/* #region CONSTANT_DEFINITION */
+#define BACKOFF_BASE 1000           // Minimum reconnect delay in millisecond
+#define BACKOFF_CAP 60000           // Maximum reconnect delay in millisecond
+#define BACKOFF_FIRST_JITTER 500    // Longest delay of a first retry to the same access point
+/* #endregion */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <Arduino.h>
+/* #endregion */
+
+/* #region CLASS_DECLARATION */
+/**
+ * Exponential backoff with decorrelated jitter.
+ * Note: Each delay is drawn between the base and three times the previous delay,
+ * bounded by the cap. Seeding per device keeps a fleet from retrying in lockstep.
+ */
+class HaCBackoff
+{
+public:
+    HaCBackoff();
+    HaCBackoff(unsigned long baseMs, unsigned long capMs);
+    void seed(uint32_t seed);
+    void seed(const uint8_t *mac);
+    unsigned long next();
+    unsigned long jitter(unsigned long spanMs = BACKOFF_FIRST_JITTER);
+    void reset();
+    uint16_t attempts();
+
+private:
+    unsigned long _baseMs = BACKOFF_BASE;
+    unsigned long _capMs = BACKOFF_CAP;
+    unsigned long _sleepMs = BACKOFF_BASE;
+    uint32_t _state = 0x9E3779B9;
+    uint16_t _attempts = 0;
+
+    uint32_t _random();
+};
+/* #endregion */
+
+#include "backoff-impl.h"
+
+#endif
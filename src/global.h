@@ -8,6 +8,7 @@ extern "C" {
 #include "lwip/err.h"
 #include "lwip/dns.h"
 #include "lwip/dhcp.h"
+#include "lwip/etharp.h"
 }
 
 #define __LITTLEFS__ LittleFS
@@ -18,6 +19,11 @@ extern "C" {
 wifi_get_ip_info(interface, ipInfo); \
 }
 #define __TCP_INFO__ struct ip_info
+#define __STA_DHCP_RESTART__() \
+{ \
+wifi_station_dhcpc_stop(); \
+wifi_station_dhcpc_start(); \
+}
 #endif
 
 #if defined(ESP32)
@@ -25,6 +31,9 @@ wifi_get_ip_info(interface, ipInfo); \
 #include <ESPmDNS.h>
 #include <LITTLEFS.h>
 #include "lwip/dns.h"
+#include "lwip/dhcp.h"
+#include "lwip/etharp.h"
+#include "lwip/priv/tcpip_priv.h"
 
 #define __LITTLEFS__ LITTLEFS
 #define __ESP_HEAPS_BLOCK_SIZE__ ESP.getMaxAllocHeap()
@@ -34,8 +43,30 @@ wifi_get_ip_info(interface, ipInfo); \
 tcpip_adapter_get_ip_info(interface, ipInfo); \
 }
 #define __TCP_INFO__ tcpip_adapter_ip_info_t
+#define __STA_DHCP_RESTART__() \
+{ \
+tcpip_adapter_dhcpc_stop(TCPIP_ADAPTER_IF_STA); \
+tcpip_adapter_dhcpc_start(TCPIP_ADAPTER_IF_STA); \
+}
 
 #define FORMAT_LITTLEFS_IF_FAILED true
+
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 2
+#define __WIFI_EVENT_SCAN_DONE__ ARDUINO_EVENT_WIFI_SCAN_DONE
+#define __WIFI_EVENT_STA_CONNECTED__ ARDUINO_EVENT_WIFI_STA_CONNECTED
+#define __WIFI_EVENT_STA_DISCONNECTED__ ARDUINO_EVENT_WIFI_STA_DISCONNECTED
+#define __WIFI_EVENT_DISCONNECT_REASON__(info) info.wifi_sta_disconnected.reason
+#else
+#define __WIFI_EVENT_SCAN_DONE__ SYSTEM_EVENT_SCAN_DONE
+#define __WIFI_EVENT_STA_CONNECTED__ SYSTEM_EVENT_STA_CONNECTED
+#define __WIFI_EVENT_STA_DISCONNECTED__ SYSTEM_EVENT_STA_DISCONNECTED
+#define __WIFI_EVENT_DISCONNECT_REASON__(info) info.disconnected.reason
+#endif
+#endif
+
+//Manager task mode, on a FreeRTOS task
+#if defined(ESP32)
+#define HAC_TASK_SUPPORT
 #endif
 
 #include <ArduinoJson.h>
@@ -0,0 +1,72 @@
+/**
+ *
+ * @file hacflow-impl.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region SELF_HEADER */
+#include "hacflow.h"
+/* #endregion */
+
+/* #region CLASS_DEFINITION */
+void HaCFlow::restart()
+{
+    this->_running = true;
+    this->_resumePoint = 0;
+    this->_waitTimeout = HAC_FLOW_NO_TIMEOUT;
+}
+
+void HaCFlow::stop()
+{
+    this->_running = false;
+    this->_resumePoint = 0;
+}
+
+bool HaCFlow::isRunning() const
+{
+    return this->_running;
+}
+
+bool HaCFlow::timedOut() const
+{
+    return this->_waitTimeout != HAC_FLOW_NO_TIMEOUT && millis() - this->_waitStart >= this->_waitTimeout;
+}
+
+unsigned long HaCFlow::timeToTimeout() const
+{
+    if (!this->_running || this->_waitTimeout == HAC_FLOW_NO_TIMEOUT) return HAC_FLOW_NO_TIMEOUT;
+
+    unsigned long elapsed = millis() - this->_waitStart;
+    return elapsed < this->_waitTimeout ? this->_waitTimeout - elapsed : 0;
+}
+
+uint16_t HaCFlow::resumePoint() const
+{
+    return this->_resumePoint;
+}
+
+void HaCFlow::wait(uint16_t resumePoint, unsigned long timeoutMs)
+{
+    this->_resumePoint = resumePoint;
+    this->_waitStart = millis();
+    this->_waitTimeout = timeoutMs;
+}
+/* #endregion */
@@ -0,0 +1,250 @@
+/**
+ *
+ * @file hacfunction.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef __HACFUNCTION_H_
+#define __HACFUNCTION_H_
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <stddef.h>
+#include <new>
+#ifdef HAC_FUNCTION_HEAP
+#include <atomic>
+#endif
+#include <type_traits>
+#include <utility>
+/* #endregion */
+
+/* #region GLOBAL_VARIABLES */
+// Inline storage of a callback, large enough for a lambda capturing a few pointers
+// Define HAC_FUNCTION_HEAP to store larger callbacks on the heap instead of rejecting them
+#ifndef HAC_FUNCTION_CAPACITY
+#define HAC_FUNCTION_CAPACITY (4 * sizeof(void *))
+#endif
+/* #endregion */
+
+/* #region CLASS_DECLARATION */
+template <typename Signature, size_t Capacity = HAC_FUNCTION_CAPACITY>
+class HaCFunction;
+
+/**
+ * Fixed capacity callable stored inline, it never allocates.
+ * Note: A callable larger than the capacity is rejected at compile time. With
+ * HAC_FUNCTION_HEAP defined it is stored on the heap once instead, and its copies
+ * share it through an atomic reference count.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class HaCFunction<R(Args...), Capacity>
+{
+public:
+    HaCFunction() {}
+    HaCFunction(std::nullptr_t) {}
+
+    template <typename F,
+              typename T = typename std::decay<F>::type,
+              typename = typename std::enable_if<!std::is_same<T, HaCFunction>::value>::type>
+    HaCFunction(F &&fn)
+    {
+        #ifndef HAC_FUNCTION_HEAP
+        static_assert(sizeof(T) <= Capacity, "Callback captures too much for HaCFunction, raise HAC_FUNCTION_CAPACITY");
+        static_assert(alignof(T) <= alignof(max_align_t), "Callback alignment not supported by HaCFunction");
+        #endif
+        this->_store<T>(std::forward<F>(fn), _FitsInline<T>());
+    }
+
+    HaCFunction(const HaCFunction &other)
+    {
+        if (other._manage) other._manage(MANAGE_COPY, &this->_storage, &other._storage);
+        this->_invoke = other._invoke;
+        this->_manage = other._manage;
+    }
+
+    HaCFunction(HaCFunction &&other) noexcept
+    {
+        this->_take(other);
+    }
+
+    HaCFunction &operator=(const HaCFunction &other)
+    {
+        if (this == &other) return *this;
+        this->_reset();
+        if (other._manage) other._manage(MANAGE_COPY, &this->_storage, &other._storage);
+        this->_invoke = other._invoke;
+        this->_manage = other._manage;
+        return *this;
+    }
+
+    HaCFunction &operator=(HaCFunction &&other) noexcept
+    {
+        if (this == &other) return *this;
+        this->_reset();
+        this->_take(other);
+        return *this;
+    }
+
+    HaCFunction &operator=(std::nullptr_t)
+    {
+        this->_reset();
+        return *this;
+    }
+
+    ~HaCFunction()
+    {
+        this->_reset();
+    }
+
+    explicit operator bool() const
+    {
+        return this->_invoke != nullptr;
+    }
+
+    R operator()(Args... args) const
+    {
+        return this->_invoke(&this->_storage, std::forward<Args>(args)...);
+    }
+
+private:
+    enum ManageOp
+    {
+        MANAGE_COPY,    // Copy src into dst
+        MANAGE_MOVE,    // Move src into dst, src is left empty
+        MANAGE_DESTROY  // Destroy dst
+    };
+    typedef R (*tInvokeFn)(const void *, Args &&...);
+    typedef void (*tManageFn)(ManageOp, void *, const void *);
+
+    #ifdef HAC_FUNCTION_HEAP
+    template <typename T>
+    struct _FitsInline : std::integral_constant<bool, sizeof(T) <= Capacity && alignof(T) <= alignof(max_align_t) &&
+                                                          std::is_nothrow_move_constructible<T>::value>
+    {
+    };
+    #else
+    template <typename T>
+    struct _FitsInline : std::true_type
+    {
+    };
+    #endif
+
+    typename std::aligned_storage<(Capacity < sizeof(void *) ? sizeof(void *) : Capacity), alignof(max_align_t)>::type _storage;
+    tInvokeFn _invoke = nullptr;
+    tManageFn _manage = nullptr;
+
+    template <typename T, typename F>
+    void _store(F &&fn, std::true_type)
+    {
+        new (&this->_storage) T(std::forward<F>(fn));
+        this->_invoke = &HaCFunction::_invokeInline<T>;
+        this->_manage = &HaCFunction::_manageInline<T>;
+    }
+
+    #ifdef HAC_FUNCTION_HEAP
+    template <typename T>
+    struct _Shared
+    {
+        template <typename F>
+        _Shared(F &&fn) : fn(std::forward<F>(fn)) {}
+        T fn;
+        std::atomic<size_t> refs{1}; // Copies may be made and released on other tasks
+    };
+
+    template <typename T, typename F>
+    void _store(F &&fn, std::false_type)
+    {
+        new (&this->_storage) _Shared<T> *(new _Shared<T>(std::forward<F>(fn)));
+        this->_invoke = &HaCFunction::_invokeHeap<T>;
+        this->_manage = &HaCFunction::_manageHeap<T>;
+    }
+    #endif
+
+    template <typename T>
+    static R _invokeInline(const void *storage, Args &&...args)
+    {
+        return (*const_cast<T *>(static_cast<const T *>(storage)))(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    static void _manageInline(ManageOp op, void *dst, const void *src)
+    {
+        switch (op)
+        {
+        case MANAGE_COPY:
+            new (dst) T(*static_cast<const T *>(src));
+            break;
+        case MANAGE_MOVE:
+            new (dst) T(std::move(*const_cast<T *>(static_cast<const T *>(src))));
+            const_cast<T *>(static_cast<const T *>(src))->~T();
+            break;
+        case MANAGE_DESTROY:
+            static_cast<T *>(dst)->~T();
+            break;
+        }
+    }
+
+    #ifdef HAC_FUNCTION_HEAP
+    template <typename T>
+    static R _invokeHeap(const void *storage, Args &&...args)
+    {
+        return (*static_cast<_Shared<T> *const *>(storage))->fn(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    static void _manageHeap(ManageOp op, void *dst, const void *src)
+    {
+        switch (op)
+        {
+        case MANAGE_COPY:
+            (*static_cast<_Shared<T> *const *>(src))->refs.fetch_add(1, std::memory_order_relaxed);
+            new (dst) _Shared<T> *(*static_cast<_Shared<T> *const *>(src));
+            break;
+        case MANAGE_MOVE:
+            new (dst) _Shared<T> *(*static_cast<_Shared<T> *const *>(src));
+            break;
+        case MANAGE_DESTROY:
+        {
+            _Shared<T> *shared = *static_cast<_Shared<T> **>(dst);
+            if (shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete shared;
+            break;
+        }
+        }
+    }
+    #endif
+
+    void _take(HaCFunction &other) noexcept
+    {
+        if (other._manage) other._manage(MANAGE_MOVE, &this->_storage, &other._storage);
+        this->_invoke = other._invoke;
+        this->_manage = other._manage;
+        other._invoke = nullptr;
+        other._manage = nullptr;
+    }
+
+    void _reset()
+    {
+        if (this->_manage) this->_manage(MANAGE_DESTROY, &this->_storage, nullptr);
+        this->_invoke = nullptr;
+        this->_manage = nullptr;
+    }
+};
+/* #endregion */
+
+#endif
@@ -23,7 +23,7 @@
  */
 
 /* #region SELF_HEADER */
-#include "HaCwifimanagerparameters.h"
+#include "hacwifimanagerparameters.h"
 /* #endregion */
 
 /* #region EXTERNAL_DEPENDENCY */
@@ -131,6 +131,28 @@ void HACWifiManagerParameters::fromJson(const char *jsonStr)
                //Initialize the rssi to the lowest dbm value
                w.rssi = -127;
 
+               //Optional network profile of the wifi, DHCP unless static is asked for
+               JsonObject network = rowData[___NETWORK___].as<JsonObject>();
+               if (!network.isNull())
+               {
+                    bool dhcp = !network.containsKey(___DHCP___) || network[___DHCP___].as<bool>();
+                    w.profile = dhcp ? PROFILE_DHCP : PROFILE_STATIC;
+                    w.network.ip = network[___IP___].as<String>();
+                    w.network.sn = network[___SN___].as<String>();
+                    w.network.gw = network[___GW___].as<String>();
+                    w.network.pdns = network[___PDNS___].as<String>();
+                    w.network.sdns = network[___SDNS___].as<String>();
+
+                    //A static network without an address would leave the station unreachable
+                    //Note: A missing key reads as "null"
+                    auto unset = [](const String &value) { return value == "" || value == "null"; };
+                    if (w.profile == PROFILE_STATIC && (unset(w.network.ip) || unset(w.network.gw)))
+                    {
+                         DEBUG_CALLBACK_HAC_PARAM2(HAC_WFM_VERBOSE_MSG143, w.ssid.c_str());
+                         w.profile = PROFILE_DHCP;
+                    }
+               }
+
                this->wifiInfo.push_back(w);
 
                /* #region Debug */
@@ -141,6 +163,7 @@ void HACWifiManagerParameters::fromJson(const char *jsonStr)
                DEBUG_CALLBACK_HAC_PARAM2(HAC_WFM_VERBOSE_MSG13, index);
                DEBUG_CALLBACK_HAC_PARAM2(HAC_WFM_VERBOSE_MSG14, this->wifiInfo[index].ssid.c_str());
                DEBUG_CALLBACK_HAC_PARAM2(HAC_WFM_VERBOSE_MSG15, this->wifiInfo[index].pass.c_str());
+               DEBUG_CALLBACK_HAC_PARAM2(HAC_WFM_VERBOSE_MSG131, this->wifiInfo[index].profile);
                /* #endregion */
           }
      }
@@ -175,6 +198,16 @@ void HACWifiManagerParameters::toJson(char * jsonConfig, uint16_t size)
      {
           doc[___WIFILIST___][String(i)][___SSID___] = this->wifiInfo[i].ssid;
           doc[___WIFILIST___][String(i)][___PASSWORD___] = this->wifiInfo[i].pass;
+
+          if (this->wifiInfo[i].profile == PROFILE_DEFAULT) continue;
+          JsonObject network = doc[___WIFILIST___][String(i)].createNestedObject(___NETWORK___);
+          network[___DHCP___] = this->wifiInfo[i].profile == PROFILE_DHCP;
+          if (this->wifiInfo[i].profile == PROFILE_DHCP) continue;
+          network[___IP___] = this->wifiInfo[i].network.ip;
+          network[___SN___] = this->wifiInfo[i].network.sn;
+          network[___GW___] = this->wifiInfo[i].network.gw;
+          network[___PDNS___] = this->wifiInfo[i].network.pdns;
+          network[___SDNS___] = this->wifiInfo[i].network.sdns;
      }
 
      doc.shrinkToFit();
@@ -379,6 +412,122 @@ bool HACWifiManagerParameters::removeWifiList(const char *ssid)
 
      return true;
 }
+/**
+     * Setting the network profile of a wifi from the wifi list
+     * @param ssid Wifi SSID
+     * @param profile Network profile, PROFILE_DEFAULT uses the global station network
+     * @param ip Static ip, used on PROFILE_STATIC only
+     * @param sn Static subnet mask, used on PROFILE_STATIC only
+     * @param gw Static gateway, used on PROFILE_STATIC only
+     * @param pdns Static primary dns, used on PROFILE_STATIC only
+     * @param sdns Static secondary dns, used on PROFILE_STATIC only
+     * @return True if the wifi exists else False
+     */
+bool HACWifiManagerParameters::setWifiNetworkProfile(const char *ssid, NetworkProfile profile,
+                                                     const char *ip, const char *sn, const char *gw,
+                                                     const char *pdns, const char *sdns)
+{
+     int16_t index = this->getWifiIndex(ssid);
+     if (index < 0) return false;
+
+     this->wifiInfo[index].profile = profile;
+     this->wifiInfo[index].network.ip = String(ip);
+     this->wifiInfo[index].network.sn = String(sn);
+     this->wifiInfo[index].network.gw = String(gw);
+     this->wifiInfo[index].network.pdns = String(pdns);
+     this->wifiInfo[index].network.sdns = String(sdns);
+     return true;
+}
+
+/**
+     * Getting the DHCP enable flag of a wifi from the wifi list
+     * @param index Index of the wifi list
+     * @return DHCP enable flag of the wifi profile, the global station flag on PROFILE_DEFAULT
+     */
+bool HACWifiManagerParameters::getWifiEnableDHCP(uint8_t index)
+{
+     if (index >= this->wifiInfo.size() || this->wifiInfo[index].profile == PROFILE_DEFAULT)
+          return this->_dhcpStaNetworkEnable;
+
+     return this->wifiInfo[index].profile == PROFILE_DHCP;
+}
+
+/**
+     * Getting the static network of a wifi from the wifi list
+     * @param index Index of the wifi list
+     * @return Static network of the wifi profile, the global station network on PROFILE_DEFAULT
+     */
+const t_networkInfo &HACWifiManagerParameters::getWifiNetworkInfo(uint8_t index)
+{
+     if (index >= this->wifiInfo.size() || this->wifiInfo[index].profile != PROFILE_STATIC)
+          return this->staNetworkInfo;
+
+     return this->wifiInfo[index].network;
+}
+
+/**
+     * Getting the index of a wifi from the wifi list
+     * @param ssid Wifi SSID
+     * @return Index of the wifi, -1 if it does not exist
+     */
+int16_t HACWifiManagerParameters::getWifiIndex(const char *ssid)
+{
+     for (uint8_t i = 0; i < this->wifiInfo.size(); i++)
+          if (this->wifiInfo[i].ssid == ssid) return i;
+
+     return -1;
+}
+
+/**
+     * Comparing the station parameters
+     * Note: The rssi and the order of the wifi list are ignored.
+     * @param other Parameters to compare with
+     * @return True if the station parameters are the same else False
+     */
+bool HACWifiManagerParameters::staEquals(HACWifiManagerParameters *other)
+{
+     if (this->_multiWifiEnable != other->_multiWifiEnable ||
+         this->_dhcpStaNetworkEnable != other->_dhcpStaNetworkEnable ||
+         strcmp(this->_hostName, other->_hostName) != 0 ||
+         !networkInfoEquals(this->staNetworkInfo, other->staNetworkInfo) ||
+         this->wifiInfo.size() != other->wifiInfo.size())
+          return false;
+
+     for (auto &entry : this->wifiInfo)
+     {
+          int16_t index = other->getWifiIndex(entry.ssid.c_str());
+          if (index < 0) return false;
+
+          t_wifiInfo &otherEntry = other->wifiInfo[index];
+          if (entry.pass != otherEntry.pass || entry.profile != otherEntry.profile ||
+              !networkInfoEquals(entry.network, otherEntry.network))
+               return false;
+     }
+     return true;
+}
+
+/**
+     * Comparing the access point parameters
+     * @param other Parameters to compare with
+     * @return True if the access point parameters are the same else False
+     */
+bool HACWifiManagerParameters::apEquals(HACWifiManagerParameters *other)
+{
+     return this->_dhcpApNetworkEnable == other->_dhcpApNetworkEnable &&
+            this->accessPointInfo.ssid == other->accessPointInfo.ssid &&
+            this->accessPointInfo.pass == other->accessPointInfo.pass &&
+            networkInfoEquals(this->apNetworkInfo, other->apNetworkInfo);
+}
+
+/**
+     * Comparing two network setups
+     * @return True if the network setups are the same else False
+     */
+bool HACWifiManagerParameters::networkInfoEquals(const t_networkInfo &a, const t_networkInfo &b)
+{
+     return a.ip == b.ip && a.sn == b.sn && a.gw == b.gw && a.pdns == b.pdns && a.sdns == b.sdns;
+}
+
 /**
      * Debug Callback function.          * 
      * @param fn Standard non return function with a const * char parameter*.
@@ -55,6 +55,7 @@
 
 /* #region INTERNAL_DEPENDENCY */
 #include "HaCWifiManagerStringConst.h"
+#include "hacfunction.h"
 
 /* #endregion */
 
@@ -83,16 +84,11 @@
 #define ___PASS___ "pass"
 #define ___PASSWORD___ "password"
 #define ___WIFILIST___ "wifilist"
+#define ___NETWORK___ "network"
+#define ___DHCP___ "dhcp"
 // typedef std::function<void()> tListGenCbFnHaCSub;                      // Standard void function with non-return value
-typedef std::function<void(const char *)> tListGenCbFnHaC1StrParamSub; // Standard void function with non-return value
-typedef std::function<void(uint8_t)> tListGenCbFnHaC1IntParamSub;      // Standard void function with non-return value
-typedef struct WifiInfo
-{
-    String ssid;
-    String pass;
-    int8_t rssi;
-} t_wifiInfo;
-
+typedef HaCFunction<void(const char *)> tListGenCbFnHaC1StrParamSub; // Standard void function with non-return value
+typedef HaCFunction<void(uint8_t)> tListGenCbFnHaC1IntParamSub;      // Standard void function with non-return value
 typedef struct NetworkInfo
 {
     String ip;
@@ -102,6 +98,22 @@ typedef struct NetworkInfo
     String sdns;
 } t_networkInfo;
 
+enum NetworkProfile
+{
+    PROFILE_DEFAULT = 0, // Use the global station network setup
+    PROFILE_DHCP = 1,    // DHCP on this network
+    PROFILE_STATIC = 2,  // Static network of this network
+};
+
+typedef struct WifiInfo
+{
+    String ssid;
+    String pass;
+    int8_t rssi;
+    NetworkProfile profile = PROFILE_DEFAULT;
+    t_networkInfo network;  // Static network, used on PROFILE_STATIC only
+} t_wifiInfo;
+
 enum NetworkType
 {
     NETWORK_STATION = 1, // Network for Station
@@ -138,6 +150,15 @@ public:
     bool editWifiList(const char *oldSsid, const char *oldPass,
                       const char *newSsid, const char *newPass);
     bool removeWifiList(const char *ssid);
+    bool setWifiNetworkProfile(const char *ssid, NetworkProfile profile,
+                               const char *ip = "", const char *sn = "", const char *gw = "",
+                               const char *pdns = "", const char *sdns = "");
+    bool getWifiEnableDHCP(uint8_t index);
+    const t_networkInfo &getWifiNetworkInfo(uint8_t index);
+    int16_t getWifiIndex(const char *ssid);
+    bool staEquals(HACWifiManagerParameters *other);
+    bool apEquals(HACWifiManagerParameters *other);
+    static bool networkInfoEquals(const t_networkInfo &a, const t_networkInfo &b);
 
     void setNetworkIP(const char *ip);
     String getNetworkIp();
@@ -175,6 +196,6 @@ private:
 
 /* #endregion */
 
-#include "HaCwifimanagerparameters-impl.h"
+#include "hacwifimanagerparameters-impl.h"
 
 #endif
\ No newline at end of file
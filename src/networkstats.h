@@ -0,0 +1,107 @@
+/**
+ *
+ * @file networkstats.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef __NETWORK_STATS_H_
+#define __NETWORK_STATS_H_
+
+/* #region CONSTANT_DEFINITION */
+#define MAX_NETWORK_STATS 6                 // Maximum networks tracked, one more than the wifi list
+#define CONNECT_ESTIMATOR_ALPHA 0.25f       // Smoothing factor once the estimator is warm
+#define CONNECT_ESTIMATOR_MIN_SAMPLES 3     // Samples required before the estimate is used
+#define QUARANTINE_AUTH_FAILURES 3          // Consecutive authentication failures before quarantine
+#define QUARANTINE_BASE 60000               // First quarantine period, doubled on every new quarantine
+#define QUARANTINE_CAP 3600000              // Maximum quarantine period
+/* #endregion */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <Arduino.h>
+#include <math.h>
+/* #endregion */
+
+/* #region CLASS_DECLARATION */
+/**
+ * Running estimate of the time to IP of a network.
+ * Note: Cumulative mean and variance for the first samples then exponentially weighted.
+ */
+class HaCConnectEstimator
+{
+public:
+    HaCConnectEstimator();
+    void addSample(unsigned long durationMs);
+    unsigned long deadline(float k, unsigned long floorMs, unsigned long ceilingMs) const;
+    uint16_t count() const;
+    float mean() const;
+    float stddev() const;
+    void reset();
+
+private:
+    float _mean = 0;
+    float _variance = 0;
+    uint16_t _count = 0;
+};
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+typedef struct DhcpLease
+{
+    uint32_t ip;
+    uint32_t sn;
+    uint32_t gw;
+    uint32_t dns1;
+    uint32_t dns2;
+    unsigned long obtainedAt;       // Time the lease was obtained from DHCP
+    uint32_t leaseTimeS;            // Lease time given by the DHCP server in second, 0 if unknown
+    bool valid;
+} t_dhcpLease;
+
+typedef struct NetworkStats
+{
+    char ssid[33];
+    unsigned long lastUsed;
+    HaCConnectEstimator timeToIp;
+    uint8_t authFailures;           // Consecutive authentication failures
+    uint8_t quarantineLevel;        // Number of quarantines since the last successful connection
+    bool quarantined;
+    unsigned long quarantineUntil;  // Release time of the quarantine
+    t_dhcpLease lease;              // Last DHCP lease, reused on reconnect
+} t_networkStats;
+/* #endregion */
+
+/* #region CLASS_DECLARATION */
+class HaCNetworkStatsTable
+{
+public:
+    HaCNetworkStatsTable();
+    t_networkStats *get(const char *ssid, bool create = true);
+    void remove(const char *ssid);
+    void clear();
+
+private:
+    t_networkStats _entries[MAX_NETWORK_STATS];
+    uint8_t _size = 0;
+};
+/* #endregion */
+
+#include "networkstats-impl.h"
+
+#endif
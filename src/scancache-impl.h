@@ -0,0 +1,169 @@
+/**
+ *
+ * @file scancache-impl.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region SELF_HEADER */
+#include "scancache.h"
+/* #endregion */
+
+/* #region CLASS_DEFINITION */
+HaCScanCache::Iterator::Iterator(const HaCScanCache *cache, uint8_t index)
+{
+    this->_cache = cache;
+    this->_index = index;
+    this->_skipExpired();
+}
+const t_scanCacheEntry &HaCScanCache::Iterator::operator*() const
+{
+    return this->_cache->_entries[this->_index];
+}
+const t_scanCacheEntry *HaCScanCache::Iterator::operator->() const
+{
+    return &this->_cache->_entries[this->_index];
+}
+HaCScanCache::Iterator &HaCScanCache::Iterator::operator++()
+{
+    this->_index++;
+    this->_skipExpired();
+    return *this;
+}
+bool HaCScanCache::Iterator::operator!=(const Iterator &other) const
+{
+    return this->_index != other._index;
+}
+void HaCScanCache::Iterator::_skipExpired()
+{
+    while (this->_index < this->_cache->_size &&
+           !this->_cache->isFresh(this->_cache->_entries[this->_index]))
+        this->_index++;
+}
+
+HaCScanCache::HaCScanCache(){}
+
+/**
+     * Setting the time to live of the cache entries.
+     * @param ttlMs Time to live in millisecond, 0 disables the cache.
+     */
+void HaCScanCache::setTTL(unsigned long ttlMs)
+{
+    this->_ttlMs = ttlMs;
+}
+unsigned long HaCScanCache::getTTL()
+{
+    return this->_ttlMs;
+}
+
+/**
+     * Insert or refresh an access point keyed by its bssid.
+     * Note: When the cache is full the oldest entry is replaced.
+     */
+void HaCScanCache::update(const char *ssid, const uint8_t *bssid, int8_t rssi, uint8_t channel)
+{
+    t_scanCacheEntry *entry = (t_scanCacheEntry *)this->find(bssid);
+    if (!entry)
+    {
+        if (this->_size < MAX_SCAN_CACHE)
+            entry = &this->_entries[this->_size++];
+        else
+        {
+            entry = &this->_entries[0];
+            for (uint8_t i = 1; i < this->_size; i++)
+                if ((long)(this->_entries[i].timestamp - entry->timestamp) < 0)
+                    entry = &this->_entries[i];
+        }
+        memcpy(entry->bssid, bssid, 6);
+    }
+    strncpy(entry->ssid, ssid, sizeof(entry->ssid) - 1);
+    entry->ssid[sizeof(entry->ssid) - 1] = '\0';
+    entry->rssi = rssi;
+    entry->channel = channel;
+    entry->timestamp = millis();
+}
+
+/**
+     * Find an access point by bssid, expired entries included.
+     * @return Cache entry or nullptr if not found
+     */
+const t_scanCacheEntry *HaCScanCache::find(const uint8_t *bssid) const
+{
+    for (uint8_t i = 0; i < this->_size; i++)
+        if (memcmp(this->_entries[i].bssid, bssid, 6) == 0)
+            return &this->_entries[i];
+    return nullptr;
+}
+
+/**
+     * Remove an access point, e.g. one which just dropped the station.
+     * @return True if the access point was cached else False
+     */
+bool HaCScanCache::remove(const uint8_t *bssid)
+{
+    t_scanCacheEntry *entry = (t_scanCacheEntry *)this->find(bssid);
+    if (!entry) return false;
+
+    *entry = this->_entries[--this->_size];
+    return true;
+}
+
+/**
+     * Strongest fresh access point broadcasting the ssid.
+     * @return Cache entry or nullptr if not found
+     */
+const t_scanCacheEntry *HaCScanCache::best(const char *ssid) const
+{
+    const t_scanCacheEntry *result = nullptr;
+    for (auto &entry : *this)
+        if (strcmp(entry.ssid, ssid) == 0 && (!result || entry.rssi > result->rssi))
+            result = &entry;
+    return result;
+}
+
+bool HaCScanCache::isFresh(const t_scanCacheEntry &entry) const
+{
+    return this->_ttlMs > 0 && (millis() - entry.timestamp) < this->_ttlMs;
+}
+
+/**
+     * Number of fresh entries.
+     */
+uint8_t HaCScanCache::count() const
+{
+    uint8_t total = 0;
+    for (auto it = this->begin(); it != this->end(); ++it) total++;
+    return total;
+}
+
+void HaCScanCache::clear()
+{
+    this->_size = 0;
+}
+
+HaCScanCache::Iterator HaCScanCache::begin() const
+{
+    return Iterator(this, 0);
+}
+HaCScanCache::Iterator HaCScanCache::end() const
+{
+    return Iterator(this, this->_size);
+}
+/* #endregion */
@@ -0,0 +1,90 @@
+/**
+ *
+ * @file scancache.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef __SCAN_CACHE_H_
+#define __SCAN_CACHE_H_
+
+/* #region CONSTANT_DEFINITION */
+#define MAX_SCAN_CACHE 16           // Maximum access point kept on the scan cache
+#define SCAN_CACHE_TTL 15000        // Default time to live of a scan cache entry in millisecond
+/* #endregion */
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <Arduino.h>
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+typedef struct ScanCacheEntry
+{
+    uint8_t bssid[6];
+    char ssid[33];
+    int8_t rssi;
+    uint8_t channel;
+    unsigned long timestamp;
+} t_scanCacheEntry;
+/* #endregion */
+
+/* #region CLASS_DECLARATION */
+class HaCScanCache
+{
+public:
+    // Read only iterator which skips the expired entries
+    class Iterator
+    {
+    public:
+        Iterator(const HaCScanCache *cache, uint8_t index);
+        const t_scanCacheEntry &operator*() const;
+        const t_scanCacheEntry *operator->() const;
+        Iterator &operator++();
+        bool operator!=(const Iterator &other) const;
+
+    private:
+        const HaCScanCache *_cache;
+        uint8_t _index;
+        void _skipExpired();
+    };
+
+    HaCScanCache();
+    void setTTL(unsigned long ttlMs);
+    unsigned long getTTL();
+    void update(const char *ssid, const uint8_t *bssid, int8_t rssi, uint8_t channel);
+    const t_scanCacheEntry *find(const uint8_t *bssid) const;
+    bool remove(const uint8_t *bssid);
+    const t_scanCacheEntry *best(const char *ssid) const;
+    bool isFresh(const t_scanCacheEntry &entry) const;
+    uint8_t count() const;
+    void clear();
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    t_scanCacheEntry _entries[MAX_SCAN_CACHE];
+    uint8_t _size = 0;
+    unsigned long _ttlMs = SCAN_CACHE_TTL;
+};
+/* #endregion */
+
+#include "scancache-impl.h"
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ *
+ * @file seqlock.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef __SEQLOCK_H_
+#define __SEQLOCK_H_
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <Arduino.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+/* #endregion */
+
+#ifndef HAC_SEQLOCK_MAX_RETRY
+#define HAC_SEQLOCK_MAX_RETRY 64        // Read attempts before giving up, the reader yields between them
+#endif
+
+/* #region CLASS_DECLARATION */
+/**
+ * Sequence lock around a plain value, one writer and any number of readers.
+ * Note: The sequence is odd while the value is written. Readers never block the
+ * writer, they copy the value and retry if the sequence moved meanwhile. A reader
+ * yields between its attempts so a writer preempted in the middle of a write can
+ * finish it, and gives up after HAC_SEQLOCK_MAX_RETRY attempts.
+ */
+template <typename T>
+class HaCSeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "HaCSeqLock value must be trivially copyable");
+
+public:
+    void write(const T &value);         // Writer side, only one task may write
+    bool tryRead(T &value) const;       // False if the value was being written
+    bool read(T &value) const;          // False if no consistent copy was read, the value is then unchanged
+    uint32_t sequence() const;          // Changes on every write
+
+private:
+    T _value;
+    std::atomic<uint32_t> _seq{0};
+};
+/* #endregion */
+
+#include "seqlock-impl.h"
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ *
+ * @file spscring-impl.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* #region SELF_HEADER */
+#include "spscring.h"
+/* #endregion */
+
+/* #region CLASS_DEFINITION */
+template <typename T, size_t Capacity>
+bool HaCSpscRing<T, Capacity>::push(const T &item)
+{
+    size_t head = this->_head.load(std::memory_order_relaxed);
+    if (head - this->_tail.load(std::memory_order_acquire) == Capacity) return false;
+
+    this->_items[head & (Capacity - 1)] = item;
+    // Publish the item before the index
+    this->_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T, size_t Capacity>
+bool HaCSpscRing<T, Capacity>::pop(T &item)
+{
+    size_t tail = this->_tail.load(std::memory_order_relaxed);
+    if (tail == this->_head.load(std::memory_order_acquire)) return false;
+
+    item = this->_items[tail & (Capacity - 1)];
+    // Release the slot once the item has been copied out
+    this->_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T, size_t Capacity>
+size_t HaCSpscRing<T, Capacity>::size() const
+{
+    return this->_head.load(std::memory_order_acquire) - this->_tail.load(std::memory_order_acquire);
+}
+
+template <typename T, size_t Capacity>
+bool HaCSpscRing<T, Capacity>::empty() const
+{
+    return this->size() == 0;
+}
+/* #endregion */
@@ -0,0 +1,58 @@
+/**
+ *
+ * @file spscring.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef __SPSCRING_H_
+#define __SPSCRING_H_
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <stddef.h>
+#include <atomic>
+/* #endregion */
+
+/* #region CLASS_DECLARATION */
+/**
+ * Lock-free single producer single consumer ring.
+ * Note: Only one task may push and only one task may pop. The indexes run freely
+ * and are masked on access, so the capacity has to be a power of two.
+ */
+template <typename T, size_t Capacity>
+class HaCSpscRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "HaCSpscRing capacity must be a power of two");
+
+public:
+    bool push(const T &item);           // Producer side, False if the ring is full
+    bool pop(T &item);                  // Consumer side, False if the ring is empty
+    size_t size() const;
+    bool empty() const;
+
+private:
+    T _items[Capacity];
+    std::atomic<size_t> _head{0};       // Next slot written by the producer
+    std::atomic<size_t> _tail{0};       // Next slot read by the consumer
+};
+/* #endregion */
+
+#include "spscring-impl.h"
+
+#endif
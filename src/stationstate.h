@@ -0,0 +1,69 @@
+/**
+ *
+ * @file stationstate.h
+ * @date 18.10.2026
+ * @author Harvy Aronales Costiniano
+ *
+ * Copyright (c) 2021 Harvy Aronales Costiniano. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef __STATION_STATE_H_
+#define __STATION_STATE_H_
+
+/* #region EXTERNAL_DEPENDENCY */
+#include <Arduino.h>
+/* #endregion */
+
+/* #region GLOBAL_DECLARATION */
+enum StationState
+{
+    STA_IDLE = 0,        // Station down, waiting for the SDK or a recovery action
+    STA_STARTING = 1,    // Station start pending until the radio settled
+    STA_SCANNING = 2,    // Multi wifi scan running
+    STA_ASSOCIATING = 3, // Connection attempt started, not yet associated
+    STA_DHCP = 4,        // Associated, waiting for an IP
+    STA_CONNECTED = 5,   // Station got an IP
+    STA_BACKOFF = 6,     // Waiting for the reconnect backoff
+    STA_STATE_COUNT = 7,
+};
+/* #endregion */
+
+/* #region CLASS_DECLARATION */
+/**
+ * Connection state of the station with its allowed transitions.
+ * Note: Transitions which are not on the transition table are rejected.
+ */
+class HaCStationStateMachine
+{
+public:
+    HaCStationStateMachine();
+    bool transition(StationState next);
+    StationState state() const;
+    unsigned long timeInState() const;
+    bool isConnecting() const;
+    static bool allowed(StationState from, StationState to);
+    static const char *name(StationState state);
+
+private:
+    StationState _state = STA_IDLE;
+    unsigned long _since = 0;
+};
+/* #endregion */
+
+#include "stationstate-impl.h"
+
+#endif